@@ -83,4 +83,13 @@ struct lab_data_buffer *buffer_convert_cairo_surface_for_icon(
 struct lab_data_buffer *buffer_create_from_data(void *pixel_data, uint32_t width,
 	uint32_t height, uint32_t stride);
 
+/* Return the lab_data_buffer backing @buffer or NULL if it is not one */
+struct lab_data_buffer *buffer_try_from_wlr_buffer(struct wlr_buffer *buffer);
+
+/*
+ * Get the number of lab_data_buffers currently alive and the total
+ * size of their pixel data in bytes.
+ */
+void buffer_get_stats(size_t *count, size_t *bytes);
+
 #endif /* LABWC_BUFFER_H */
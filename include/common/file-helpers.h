@@ -2,6 +2,10 @@
 #ifndef LABWC_FILE_HELPERS_H
 #define LABWC_FILE_HELPERS_H
 #include <stdbool.h>
+#include <stdint.h>
+
+/* Initial value for file_fingerprint() and dir_fingerprint() */
+#define FINGERPRINT_INIT 0xcbf29ce484222325
 
 /**
  * file_exists() - Test if file exists.
@@ -9,4 +13,20 @@
  */
 bool file_exists(const char *filename);
 
+/**
+ * file_fingerprint() - Add file name, identity and mtime to hash.
+ * @hash: Hash to add to, FINGERPRINT_INIT or a previous result.
+ * @filename: Name of file. Missing files only contribute their name.
+ * Return: Updated hash.
+ */
+uint64_t file_fingerprint(uint64_t hash, const char *filename);
+
+/**
+ * dir_fingerprint() - Add directory and its non-hidden entries to hash.
+ * @hash: Hash to add to, FINGERPRINT_INIT or a previous result.
+ * @dirname: Name of directory. Subdirectories are not recursed into.
+ * Return: Updated hash.
+ */
+uint64_t dir_fingerprint(uint64_t hash, const char *dirname);
+
 #endif /* LABWC_FILE_HELPERS_H */
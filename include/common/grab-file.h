@@ -8,12 +8,20 @@
 #ifndef LABWC_GRAB_FILE_H
 #define LABWC_GRAB_FILE_H
 
+#include <stdio.h>
 #include "common/buf.h"
 
+/**
+ * grab_stream - read stream into memory buffer
+ * @stream: stream to read, for example from fopen() or popen()
+ * Newlines are stripped. Free returned buffer with buf_reset().
+ */
+struct buf grab_stream(FILE *stream);
+
 /**
  * grab_file - read file into memory buffer
  * @filename: file to read
- * Free returned buffer with buf_reset().
+ * Newlines are stripped. Free returned buffer with buf_reset().
  */
 struct buf grab_file(const char *filename);
 
@@ -4,6 +4,8 @@
 
 #include <stdbool.h>
 
+struct match_pattern;
+
 /**
  * match_glob() - Pattern match using '*' wildcards and '?' jokers.
  * @pattern: Pattern to match against.
@@ -12,4 +14,23 @@
  */
 bool match_glob(const char *pattern, const char *string);
 
+/**
+ * match_pattern_create() - Compile a pattern for repeated use.
+ * @pattern: Pattern using '*' wildcards and '?' jokers.
+ *
+ * Plain strings, prefixes, suffixes and substrings are matched directly,
+ * other patterns by a small NFA. Anything beyond '*' and '?' is handed
+ * to fnmatch() so that the result is always the same as for match_glob().
+ * Return: compiled pattern, free with match_pattern_destroy().
+ */
+struct match_pattern *match_pattern_create(const char *pattern);
+
+/**
+ * match_pattern() - Same as match_glob() but using a compiled pattern.
+ * Note: Comparison case-insensitive.
+ */
+bool match_pattern(const struct match_pattern *pattern, const char *string);
+
+void match_pattern_destroy(struct match_pattern *pattern);
+
 #endif /* LABWC_MATCH_H */
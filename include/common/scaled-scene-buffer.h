@@ -2,6 +2,7 @@
 #ifndef LABWC_SCALED_SCENE_BUFFER_H
 #define LABWC_SCALED_SCENE_BUFFER_H
 
+#include <stddef.h>
 #include <wayland-server-core.h>
 
 #define LAB_SCALED_BUFFER_MAX_CACHE 2
@@ -84,6 +85,16 @@ struct scaled_scene_buffer *scaled_scene_buffer_create(
 /* Clear the cache of existing buffers, useful in case the content changes */
 void scaled_scene_buffer_invalidate_cache(struct scaled_scene_buffer *self);
 
+struct scaled_scene_buffer_stats {
+	size_t instances;
+	size_t cache_entries;
+	size_t hits;    /* scale change served from the cache */
+	size_t misses;  /* buffer (re-)rendered via impl->create_buffer() */
+};
+
+/* Get global counters for all scaled_scene_buffers, used for debugging */
+void scaled_scene_buffer_get_stats(struct scaled_scene_buffer_stats *stats);
+
 /* Private */
 struct scaled_scene_buffer_cache_entry {
 	struct wl_list link;   /* struct scaled_scene_buffer.cache */
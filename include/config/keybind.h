@@ -40,4 +40,26 @@ uint32_t parse_modifier(const char *symname);
 bool keybind_the_same(struct keybind *a, struct keybind *b);
 
 void keybind_update_keycodes(struct server *server);
+
+/**
+ * keybind_index_rebuild - rebuild the lookup tables used by
+ * keybind_index_lookup() from rc.keybinds. Must be called whenever
+ * keybinds or their keycodes change.
+ */
+void keybind_index_rebuild(void);
+
+/* Free the lookup tables before freeing the keybinds they point to */
+void keybind_index_finish(void);
+
+/**
+ * keybind_index_lookup - find keybinds matching a key
+ * @modifiers: exact modifier mask
+ * @sym: keysym or XKB_KEY_NoSymbol to match @keycode instead
+ * @keycode: keycode of the physical key
+ *
+ * Returns an array of struct keybind pointers in rc.keybinds order
+ * or NULL if there are none.
+ */
+struct wl_array *keybind_index_lookup(uint32_t modifiers, xkb_keysym_t sym,
+	xkb_keycode_t keycode);
 #endif /* LABWC_KEYBIND_H */
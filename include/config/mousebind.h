@@ -42,6 +42,9 @@ struct mousebind {
 
 	struct wl_list link;     /* struct rcxml.mousebinds */
 	bool pressed_in_context; /* used in click events */
+
+	/* bit n is set if context contains enum ssd_part_type n */
+	uint64_t context_mask;
 };
 
 enum mouse_event mousebind_event_from_str(const char *str);
@@ -50,4 +53,28 @@ enum direction mousebind_direction_from_str(const char *str, uint32_t *modifiers
 struct mousebind *mousebind_create(const char *context);
 bool mousebind_the_same(struct mousebind *a, struct mousebind *b);
 
+/**
+ * mousebind_index_rebuild - rebuild the lookup table used by the
+ * mousebind_index_lookup_*() functions from rc.mousebinds
+ */
+void mousebind_index_rebuild(void);
+
+/* Free the lookup table before freeing the mousebinds it points to */
+void mousebind_index_finish(void);
+
+/*
+ * Return an array of struct mousebind pointers in rc.mousebinds order
+ * with exactly these modifiers, or NULL if there are none. Button
+ * lookups return all mouse events except scroll, scroll lookups only
+ * return scroll events.
+ */
+struct wl_array *mousebind_index_lookup_button(uint32_t modifiers,
+	uint32_t button);
+struct wl_array *mousebind_index_lookup_scroll(uint32_t modifiers,
+	enum direction direction);
+
+/* Same as ssd_part_contains(mousebind->context, type) but cheaper */
+bool mousebind_in_context(struct mousebind *mousebind,
+	enum ssd_part_type type);
+
 #endif /* LABWC_MOUSEBIND_H */
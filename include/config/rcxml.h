@@ -38,6 +38,12 @@ enum tearing_mode {
 	LAB_TEARING_FULLSCREEN_FORCED,
 };
 
+enum modifier_broadcast_mode {
+	LAB_MODIFIER_BROADCAST_ALL = 0,
+	LAB_MODIFIER_BROADCAST_POINTER,
+	LAB_MODIFIER_BROADCAST_NONE,
+};
+
 enum tiling_events_mode {
 	LAB_TILING_EVENTS_NEVER = 0,
 	LAB_TILING_EVENTS_REGION = 1 << 0,
@@ -69,6 +75,9 @@ struct rcxml {
 	enum adaptive_sync_mode adaptive_sync;
 	enum tearing_mode allow_tearing;
 	bool reuse_output_mode;
+	bool latency_probe;
+	int hidden_frame_rate;
+	int inactive_frame_rate;
 	enum view_placement_policy placement_policy;
 	bool xwayland_persistence;
 	int placement_cascade_offset_x;
@@ -78,6 +87,7 @@ struct rcxml {
 	bool focus_follow_mouse;
 	bool focus_follow_mouse_requires_movement;
 	bool raise_on_focus;
+	bool defer_map_focus;
 
 	/* theme */
 	char *theme_name;
@@ -106,6 +116,7 @@ struct rcxml {
 	int repeat_delay;
 	bool kb_numlock_enable;
 	bool kb_layout_per_window;
+	enum modifier_broadcast_mode modifier_broadcast;
 	struct wl_list keybinds;   /* struct keybind.link */
 
 	/* mouse */
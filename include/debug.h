@@ -2,8 +2,22 @@
 #ifndef LABWC_DEBUG_H
 #define LABWC_DEBUG_H
 
+#include <stdbool.h>
+
 struct server;
 
 void debug_dump_scene(struct server *server);
 
+/**
+ * debug_dump_memory() - report scene nodes and buffer memory
+ * @filename: file to write to or NULL for stdout
+ * @json: write JSON instead of a human readable table
+ *
+ * Scene nodes and the pixel data of lab_data_buffers are attributed to
+ * client surfaces, decorations, menus, OSDs and individual views.
+ * Global lab_data_buffer and scaled_scene_buffer cache counters are
+ * included as well.
+ */
+void debug_dump_memory(struct server *server, const char *filename, bool json);
+
 #endif /* LABWC_DEBUG_H */
@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_FRAME_STATS_H
+#define LABWC_FRAME_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+struct output;
+struct server;
+struct frame_stats;
+struct wlr_input_device;
+struct wlr_output_event_present;
+
+/* Durations sampled into a rolling window per output */
+enum frame_stat {
+	LAB_FRAME_STAT_FRAME_TO_COMMIT = 0,
+	LAB_FRAME_STAT_BUILD_STATE,
+	LAB_FRAME_STAT_TEARING_TEST,
+	LAB_FRAME_STAT_MAGNIFY,
+	LAB_FRAME_STAT_COMMIT,
+	LAB_FRAME_STAT_INPUT_TO_PHOTON,
+
+	LAB_FRAME_STAT_COUNT
+};
+
+/* Monotonic event counters per output */
+enum frame_counter {
+	LAB_FRAME_COUNTER_FRAMES = 0,
+	LAB_FRAME_COUNTER_SKIPPED,
+	LAB_FRAME_COUNTER_FAILED,
+	/* Frames which showed a client buffer directly, without rendering */
+	LAB_FRAME_COUNTER_SCANOUT,
+	LAB_FRAME_COUNTER_COMPOSITED,
+
+	LAB_FRAME_COUNTER_COUNT
+};
+
+struct frame_stats *frame_stats_create(void);
+void frame_stats_destroy(struct frame_stats *stats);
+
+/**
+ * frame_stats_frame_begin() - mark the start of an output frame event
+ * Increments the frame counter and remembers the current time so that
+ * frame_stats_frame_committed() can record the frame-to-commit latency.
+ */
+void frame_stats_frame_begin(struct frame_stats *stats);
+
+/**
+ * frame_stats_frame_committed() - record frame-to-commit latency
+ * Does nothing if no frame is pending, for example for commits that are
+ * not driven by a frame event.
+ */
+void frame_stats_frame_committed(struct frame_stats *stats);
+
+/**
+ * frame_stats_lap() - record the time elapsed since @since
+ * @since is updated to the current time so that consecutive phases can be
+ * measured by calling this function repeatedly with the same timestamp.
+ */
+void frame_stats_lap(struct frame_stats *stats, enum frame_stat stat,
+	struct timespec *since);
+
+void frame_stats_inc(struct frame_stats *stats, enum frame_counter counter);
+
+/**
+ * frame_stats_input() - note the arrival of an input event
+ * @output: output expected to show the result of the event, may be NULL
+ * @device: the device which generated the event
+ *
+ * Part of the input-to-photon latency probe which is only active when
+ * <core><latencyProbe> is enabled. The oldest event which arrived since
+ * the last commit is attached to the next commit and its latency is
+ * recorded when that commit has been presented.
+ */
+void frame_stats_input(struct output *output, struct wlr_input_device *device);
+
+/**
+ * frame_stats_commit_begin() - attach pending input to an output commit
+ * @commit_seq: the sequence number the commit will have when it succeeds
+ */
+void frame_stats_commit_begin(struct frame_stats *stats, uint32_t commit_seq);
+
+/**
+ * frame_stats_commit_failed() - hand pending input to the next commit
+ */
+void frame_stats_commit_failed(struct frame_stats *stats);
+
+/**
+ * frame_stats_presented() - record input-to-photon latency
+ * Must be connected to the present event of the output.
+ */
+void frame_stats_presented(struct frame_stats *stats,
+	struct wlr_output_event_present *event);
+
+/* Free the per-device latency statistics */
+void frame_stats_finish(void);
+
+/**
+ * frame_stats_dump() - print p50/p95/p99/max for all outputs
+ * Input-to-photon latency is additionally broken down per input device
+ * when the latency probe is enabled.
+ * @filename: file to write to or NULL for stdout
+ * @reset: clear all samples and counters after dumping
+ */
+void frame_stats_dump(struct server *server, const char *filename, bool reset);
+
+#endif /* LABWC_FRAME_STATS_H */
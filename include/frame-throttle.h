@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_FRAME_THROTTLE_H
+#define LABWC_FRAME_THROTTLE_H
+
+#include <time.h>
+
+struct output;
+struct server;
+
+/*
+ * Frame callback policy for views which are not in the user's focus, see
+ * <core><hiddenFrameRate> and <core><inactiveFrameRate>.
+ */
+
+/**
+ * frame_throttle_send_frame_done() - send frame done events for an output
+ * Replacement for wlr_scene_output_send_frame_done() which holds back
+ * the callbacks of unfocused views until their frame interval is over.
+ * Must be called at the end of each output frame event.
+ */
+void frame_throttle_send_frame_done(struct output *output,
+	struct timespec *now);
+
+/* (Re-)arm the timer which sends frame done events to hidden views */
+void frame_throttle_reconfigure(struct server *server);
+
+void frame_throttle_output_finish(struct output *output);
+void frame_throttle_finish(struct server *server);
+
+#endif /* LABWC_FRAME_THROTTLE_H */
@@ -125,6 +125,16 @@ void cursor_update_image(struct seat *seat);
  */
 bool cursor_process_motion(struct server *server, uint32_t time, double *sx, double *sy);
 
+/**
+ * cursor_flush_move - move the grabbed view to follow the cursor
+ * @server - server
+ *
+ * During interactive move, cursor motion is only recorded and the view
+ * is moved once per output frame. This is called from the output frame
+ * handler and whenever the final position is needed right away.
+ */
+void cursor_flush_move(struct server *server);
+
 /**
  * Processes cursor button press. The return value indicates if a client
  * should be notified.
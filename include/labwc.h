@@ -120,6 +120,17 @@ struct seat {
 	/* In support for ToggleKeybinds */
 	uint32_t nr_inhibited_keybind_views;
 
+	/* Modifiers sent to clients without keyboard focus, see keyboard.c */
+	struct {
+		struct wl_event_source *idle;
+		struct wlr_keyboard_modifiers pending;
+		/* Last broadcast; the clients are only compared, never used */
+		bool sent_valid;
+		struct wlr_keyboard_modifiers sent;
+		struct wlr_seat_client *sent_focused;
+		struct wlr_seat_client *sent_target;
+	} modifier_broadcast;
+
 	/* Used to hide the workspace OSD after switching workspaces */
 	struct wl_event_source *workspace_osd_timer;
 	bool workspace_osd_shown_by_modifier;
@@ -265,6 +276,14 @@ struct server {
 	/* View geometry when interactive move/resize is requested */
 	struct wlr_box grab_box;
 	uint32_t resize_edges;
+	/*
+	 * Latest geometry requested by interactive resize while the client
+	 * has not yet caught up with the previous configure request
+	 */
+	struct wlr_box resize_pending_geo;
+	bool resize_pending;
+	/* Cursor moved during interactive move, see cursor_flush_move() */
+	bool move_pending;
 
 	/*
 	 * 'active_view' is generally the view with keyboard-focus, updated with
@@ -275,11 +294,24 @@ struct server {
 	 * for foreign-toplevel protocol.
 	 */
 	struct view *active_view;
+	/* Sends frame callbacks to hidden views, see frame-throttle.c */
+	struct wl_event_source *hidden_frame_timer;
 	/*
 	 * Most recently raised view. Used to avoid unnecessarily
 	 * raising the same view over and over.
 	 */
 	struct view *last_raised_view;
+	/*
+	 * With <focus><deferMapFocus>, views mapped for the first time are
+	 * raised immediately but only the last one of a burst is focused,
+	 * once the event loop is idle.
+	 */
+	struct {
+		struct wl_event_source *idle;
+		struct view *focus;
+		/* Workspace of the view when it was queued */
+		struct workspace *workspace;
+	} map_batch;
 
 	struct ssd_hover_state *ssd_hover_state;
 
@@ -400,12 +432,23 @@ struct output {
 
 	struct lab_data_buffer *osd_buffer;
 
+	/* Rolling frame timings, see frame_stats_dump() */
+	struct frame_stats *frame_stats;
+
+	/* Schedules a frame for held back frame callbacks */
+	struct wl_event_source *frame_throttle_timer;
+
 	struct wl_listener destroy;
 	struct wl_listener frame;
+	struct wl_listener present;
 	struct wl_listener request_state;
 
 	bool leased;
 	bool gamma_lut_changed;
+
+	/* State of the last commit, see update_direct_scanout() */
+	bool direct_scanout;
+	bool fullscreen_on_top;
 };
 
 #undef LAB_NR_LAYERS
@@ -456,6 +499,13 @@ void desktop_focus_view_or_surface(struct seat *seat, struct view *view,
 	struct wlr_surface *surface, bool raise);
 
 void desktop_arrange_all_views(struct server *server);
+
+/**
+ * desktop_arrange_views_on_output() - like desktop_arrange_all_views() but
+ * limited to views affected by a change of the usable area of @output.
+ * The output layout itself must not have changed.
+ */
+void desktop_arrange_views_on_output(struct output *output);
 void desktop_focus_output(struct output *output);
 void warp_cursor(struct view *view);
 struct view *desktop_topmost_focusable_view(struct server *server);
@@ -514,6 +564,14 @@ void interactive_anchor_to_cursor(struct server *server, struct wlr_box *geo);
 void interactive_begin(struct view *view, enum input_mode mode, uint32_t edges);
 void interactive_finish(struct view *view);
 void interactive_cancel(struct view *view);
+
+/**
+ * interactive_resize_configure_done() - notify interactive resize that
+ * the view has no outstanding configure request anymore, either because
+ * the client committed the requested size or because it timed out.
+ * Sends the latest geometry coalesced in the meantime, if any.
+ */
+void interactive_resize_configure_done(struct view *view);
 /* Possibly returns VIEW_EDGE_CENTER if <topMaximize> is yes */
 enum view_edge edge_from_cursor(struct seat *seat, struct output **dest_output);
 
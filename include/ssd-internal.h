@@ -42,10 +42,39 @@ struct ssd_state_title_width {
 	bool truncated;
 };
 
+/* Max number of buttons tracked per titlebar side in struct ssd_layout */
+#define SSD_LAYOUT_MAX_BUTTONS 16
+
+/*
+ * Theme and config values that determine the structure and geometry of the
+ * decorations. If any of these change on Reconfigure, the decorations have
+ * to be re-created. Otherwise they can be updated in place.
+ */
+struct ssd_layout {
+	int title_height;
+	int border_width;
+	int corner_width;
+	int padding_width;
+	int button_width;
+	int button_height;
+	int button_spacing;
+	bool show_title;
+	bool shadows_enabled;
+	int active_shadow_size;
+	int inactive_shadow_size;
+	int nr_buttons_left;
+	int nr_buttons_right;
+	enum ssd_part_type buttons_left[SSD_LAYOUT_MAX_BUTTONS];
+	enum ssd_part_type buttons_right[SSD_LAYOUT_MAX_BUTTONS];
+};
+
 struct ssd {
 	struct view *view;
 	struct wlr_scene_tree *tree;
 
+	/* Layout the decorations were created with */
+	struct ssd_layout layout;
+
 	/*
 	 * Cache for current values.
 	 * Used to detect actual changes so we
@@ -71,6 +100,13 @@ struct ssd {
 		 */
 		bool was_squared;
 
+		/*
+		 * Extents were not clipped by any usable area boundary on the
+		 * last update, so moving the view does not require an update
+		 * as long as they stay inside the usable area.
+		 */
+		bool extents_unclipped;
+
 		struct wlr_box geometry;
 		struct ssd_state_title {
 			char *text;
@@ -159,19 +195,24 @@ void ssd_destroy_parts(struct wl_list *list);
 /* SSD internal */
 void ssd_titlebar_create(struct ssd *ssd);
 void ssd_titlebar_update(struct ssd *ssd);
+bool ssd_titlebar_reconfigure(struct ssd *ssd);
 void ssd_titlebar_destroy(struct ssd *ssd);
 bool ssd_should_be_squared(struct ssd *ssd);
 
 void ssd_border_create(struct ssd *ssd);
 void ssd_border_update(struct ssd *ssd);
+void ssd_border_reconfigure(struct ssd *ssd);
 void ssd_border_destroy(struct ssd *ssd);
 
 void ssd_extents_create(struct ssd *ssd);
 void ssd_extents_update(struct ssd *ssd);
+/* Returns false if a pure move of the view needs no extents update */
+bool ssd_extents_may_clip(struct ssd *ssd);
 void ssd_extents_destroy(struct ssd *ssd);
 
 void ssd_shadow_create(struct ssd *ssd);
 void ssd_shadow_update(struct ssd *ssd);
+void ssd_shadow_reconfigure(struct ssd *ssd);
 void ssd_shadow_destroy(struct ssd *ssd);
 
 #endif /* LABWC_SSD_INTERNAL_H */
@@ -93,6 +93,13 @@ void ssd_set_active(struct ssd *ssd, bool active);
 void ssd_update_title(struct ssd *ssd);
 void ssd_update_geometry(struct ssd *ssd);
 void ssd_destroy(struct ssd *ssd);
+
+/*
+ * Update decorations in place after the theme or config has been reloaded.
+ * Returns false if the layout changed, in which case the decorations have
+ * to be re-created instead.
+ */
+bool ssd_reconfigure(struct ssd *ssd);
 void ssd_set_titlebar(struct ssd *ssd, bool enabled);
 void ssd_update_window_icon(struct ssd *ssd);
 
@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_TRACE_H
+#define LABWC_TRACE_H
+#include "config.h"
+
+#if HAVE_TRACE
+
+/*
+ * Tracing spans are written to the ftrace trace_marker file using the
+ * atrace "B|pid|name" / "E|pid" format, so that they show up as slices
+ * in perfetto and can be correlated with kernel and client events.
+ *
+ * Enable with -Dtrace=enabled. When disabled, TRACE_SPAN() compiles to
+ * nothing.
+ */
+
+/**
+ * TRACE_SPAN() - trace the remainder of the current scope
+ * @name: static string used as the slice name
+ * The span is ended automatically when the scope is left, including early
+ * returns. Only one span can be declared per scope.
+ */
+#define TRACE_SPAN(name) \
+	const char *trace_span __attribute__((cleanup(trace_span_end), unused)) = \
+		trace_span_begin(name)
+
+const char *trace_span_begin(const char *name);
+void trace_span_end(const char **name);
+
+#else
+
+#define TRACE_SPAN(name) do { } while (0)
+
+#endif /* HAVE_TRACE */
+
+#endif /* LABWC_TRACE_H */
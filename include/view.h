@@ -5,6 +5,7 @@
 #include "config/rcxml.h"
 #include "config.h"
 #include "ssd.h"
+#include "window-rules.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <wayland-util.h>
@@ -109,6 +110,7 @@ enum window_type {
 	WINDOW_TYPE_LEN
 };
 
+struct match_pattern;
 struct view;
 struct wlr_surface;
 
@@ -160,6 +162,8 @@ struct view_impl {
 	bool (*contains_window_type)(struct view *view, int32_t window_type);
 	/* returns the client pid that this view belongs to */
 	pid_t (*get_pid)(struct view *view);
+	/* sends a configure deferred during interactive move, optional */
+	void (*flush_configure)(struct view *view);
 };
 
 struct view {
@@ -209,6 +213,8 @@ struct view {
 	enum view_axis maximized;
 	bool fullscreen;
 	bool tearing_hint;
+	/* Time of the last frame callback while throttled, see frame-throttle.c */
+	int64_t frame_done_usec;
 	enum three_state force_tearing;
 	bool visible_on_all_workspaces;
 	enum view_edge tiled;
@@ -248,6 +254,9 @@ struct view {
 	 */
 	struct wlr_box last_layout_geometry;
 
+	/* See window_rules_get_property() */
+	struct window_rules_cache window_rules_cache;
+
 	/* used by xdg-shell views */
 	uint32_t pending_configure_serial;
 	struct wl_event_source *pending_configure_timeout;
@@ -290,18 +299,18 @@ struct view {
 
 struct view_query {
 	struct wl_list link;
-	char *identifier;
-	char *title;
+	struct match_pattern *identifier;
+	struct match_pattern *title;
 	int window_type;
-	char *sandbox_engine;
-	char *sandbox_app_id;
+	struct match_pattern *sandbox_engine;
+	struct match_pattern *sandbox_app_id;
 	enum three_state shaded;
 	enum view_axis maximized;
 	enum three_state iconified;
 	enum three_state focused;
 	enum three_state omnipresent;
 	enum view_edge tiled;
-	char *tiled_region;
+	struct match_pattern *tiled_region;
 	char *desktop;
 	enum ssd_mode decoration;
 	char *monitor;
@@ -311,6 +320,9 @@ struct xdg_toplevel_view {
 	struct view base;
 	struct wlr_xdg_surface *xdg_surface;
 
+	/* Window type as last seen by window rules */
+	bool is_dialog;
+
 	/* Events unique to xdg-toplevel views */
 	struct wl_listener set_app_id;
 	struct wl_listener request_show_window_menu;
@@ -566,6 +578,14 @@ bool view_on_output(struct view *view, struct output *output);
  */
 bool view_has_strut_partial(struct view *view);
 
+/**
+ * view_flush_configure() - let the client know about its current geometry
+ * during and after interactive move. Some view types (XWayland) do not
+ * notify the client about every position change during interactive move,
+ * this is called once per frame and when the move ends.
+ */
+void view_flush_configure(struct view *view);
+
 const char *view_get_string_prop(struct view *view, const char *prop);
 void view_update_title(struct view *view);
 void view_update_app_id(struct view *view);
@@ -3,8 +3,11 @@
 #define LABWC_WINDOW_RULES_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <wayland-util.h>
 
+struct match_pattern;
+
 enum window_rule_event {
 	LAB_WINDOW_RULE_EVENT_ON_FIRST_MAP = 0,
 };
@@ -16,17 +19,39 @@ enum property {
 	LAB_PROP_TRUE,
 };
 
+/* Properties which can be queried with window_rules_get_property() */
+enum window_rule_prop {
+	LAB_WINDOW_RULE_PROP_SERVER_DECORATION = 0,
+	LAB_WINDOW_RULE_PROP_SKIP_TASKBAR,
+	LAB_WINDOW_RULE_PROP_SKIP_WINDOW_SWITCHER,
+	LAB_WINDOW_RULE_PROP_IGNORE_FOCUS_REQUEST,
+	LAB_WINDOW_RULE_PROP_IGNORE_CONFIGURE_REQUEST,
+	LAB_WINDOW_RULE_PROP_FIXED_POSITION,
+
+	LAB_WINDOW_RULE_PROP_COUNT
+};
+
+/*
+ * Per-view result of evaluating all window rules, see
+ * window_rules_get_property(). Only valid while generation matches
+ * the global generation in window-rules.c, so zero means invalid.
+ */
+struct window_rules_cache {
+	uint32_t generation;
+	enum property props[LAB_WINDOW_RULE_PROP_COUNT];
+};
+
 /*
  * 'identifier' represents:
  *   - 'app_id' for native Wayland windows
  *   - 'WM_CLASS' for XWayland clients
  */
 struct window_rule {
-	char *identifier;
-	char *title;
+	struct match_pattern *identifier;
+	struct match_pattern *title;
 	int window_type;
-	char *sandbox_engine;
-	char *sandbox_app_id;
+	struct match_pattern *sandbox_engine;
+	struct match_pattern *sandbox_app_id;
 	bool match_once;
 
 	enum window_rule_event event;
@@ -45,6 +70,24 @@ struct window_rule {
 struct view;
 
 void window_rules_apply(struct view *view, enum window_rule_event event);
+
+/**
+ * window_rules_get_property() - get the value a window rule sets for a view
+ * The rules are evaluated once per view and the result is cached until
+ * window_rules_invalidate() or window_rules_update() is called.
+ */
 enum property window_rules_get_property(struct view *view, const char *property);
 
+/**
+ * window_rules_invalidate() - forget cached window rule results
+ * Must be called whenever anything a rule can match on changes, i.e. the
+ * app_id, title, window type or sandbox info of @view, and when a view is
+ * created or destroyed. If there are matchOnce rules, the results of all
+ * views are dropped as they depend on the other views.
+ */
+void window_rules_invalidate(struct view *view);
+
+/* Drop the results of all views, called after rc.window_rules has changed */
+void window_rules_update(void);
+
 #endif /* LABWC_WINDOW_RULES_H */
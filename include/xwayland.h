@@ -11,6 +11,7 @@
 #include "view.h"
 
 struct wlr_compositor;
+struct output;
 struct wlr_output;
 struct wlr_output_layout;
 
@@ -71,6 +72,9 @@ struct xwayland_view {
 	struct wl_listener set_window_type;
 	struct wl_listener map_request;
 
+	/* X11 position is out of date, see xwayland_view_configure() */
+	bool configure_deferred;
+
 	/* Not (yet) implemented */
 /*	struct wl_listener set_role; */
 /*	struct wl_listener set_hints; */
@@ -96,6 +100,13 @@ void xwayland_adjust_usable_area(struct view *view,
 
 void xwayland_update_workarea(struct server *server);
 
+/**
+ * xwayland_output_affects_workarea() - check whether the usable area of
+ * @output contributes to _NET_WORKAREA, which is only the case for outputs
+ * aligned with an outer edge of the layout.
+ */
+bool xwayland_output_affects_workarea(struct output *output);
+
 void xwayland_reset_cursor(struct server *server);
 
 #endif /* HAVE_XWAYLAND */
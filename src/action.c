@@ -14,6 +14,7 @@
 #include "common/spawn.h"
 #include "common/string-helpers.h"
 #include "debug.h"
+#include "frame-stats.h"
 #include "labwc.h"
 #include "magnifier.h"
 #include "menu/menu.h"
@@ -121,7 +122,9 @@ enum action_type {
 	ACTION_TYPE_TOGGLE_TABLET_MOUSE_EMULATION,
 	ACTION_TYPE_TOGGLE_MAGNIFY,
 	ACTION_TYPE_ZOOM_IN,
-	ACTION_TYPE_ZOOM_OUT
+	ACTION_TYPE_ZOOM_OUT,
+	ACTION_TYPE_DUMP_FRAME_STATS,
+	ACTION_TYPE_DUMP_MEMORY_STATS
 };
 
 const char *action_names[] = {
@@ -186,6 +189,8 @@ const char *action_names[] = {
 	"ToggleMagnify",
 	"ZoomIn",
 	"ZoomOut",
+	"DumpFrameStats",
+	"DumpMemoryStats",
 	NULL
 };
 
@@ -475,6 +480,26 @@ action_arg_from_xml_node(struct action *action, const char *nodename, const char
 			goto cleanup;
 		}
 		break;
+	case ACTION_TYPE_DUMP_FRAME_STATS:
+		if (!strcmp(argument, "file")) {
+			action_arg_add_str(action, argument, content);
+			goto cleanup;
+		}
+		if (!strcmp(argument, "reset")) {
+			action_arg_add_bool(action, argument, parse_bool(content, false));
+			goto cleanup;
+		}
+		break;
+	case ACTION_TYPE_DUMP_MEMORY_STATS:
+		if (!strcmp(argument, "file")) {
+			action_arg_add_str(action, argument, content);
+			goto cleanup;
+		}
+		if (!strcmp(argument, "json")) {
+			action_arg_add_bool(action, argument, parse_bool(content, false));
+			goto cleanup;
+		}
+		break;
 	}
 
 	wlr_log(WLR_ERROR, "Invalid argument for action %s: '%s'",
@@ -761,6 +786,22 @@ view_for_action(struct view *activator, struct server *server,
 	}
 }
 
+/* Returns the tilde-expanded file argument or NULL to use stdout */
+static char *
+get_dump_filename(struct action *action)
+{
+	const char *file = action_get_str(action, "file", NULL);
+	if (!file) {
+		return NULL;
+	}
+	struct buf path = BUF_INIT;
+	buf_add(&path, file);
+	buf_expand_tilde(&path);
+	char *ret = xstrdup(path.data);
+	buf_reset(&path);
+	return ret;
+}
+
 static bool
 run_if_action(struct view *view, struct server *server, struct action *action)
 {
@@ -1293,6 +1334,22 @@ actions_run(struct view *activator, struct server *server,
 		case ACTION_TYPE_ZOOM_OUT:
 			magnify_set_scale(server, MAGNIFY_DECREASE);
 			break;
+		case ACTION_TYPE_DUMP_FRAME_STATS:
+			{
+				char *file = get_dump_filename(action);
+				frame_stats_dump(server, file,
+					action_get_bool(action, "reset", false));
+				free(file);
+			}
+			break;
+		case ACTION_TYPE_DUMP_MEMORY_STATS:
+			{
+				char *file = get_dump_filename(action);
+				debug_dump_memory(server, file,
+					action_get_bool(action, "json", false));
+				free(file);
+			}
+			break;
 		case ACTION_TYPE_INVALID:
 			wlr_log(WLR_ERROR, "Not executing unknown action");
 			break;
@@ -34,6 +34,16 @@
 
 static const struct wlr_buffer_impl data_buffer_impl;
 
+/* Live lab_data_buffers, reported by buffer_get_stats() */
+static size_t live_count;
+static size_t live_bytes;
+
+static size_t
+data_size(struct lab_data_buffer *buffer)
+{
+	return buffer->stride * buffer->base.height;
+}
+
 static struct lab_data_buffer *
 data_buffer_from_buffer(struct wlr_buffer *buffer)
 {
@@ -45,6 +55,8 @@ static void
 data_buffer_destroy(struct wlr_buffer *wlr_buffer)
 {
 	struct lab_data_buffer *buffer = data_buffer_from_buffer(wlr_buffer);
+	live_count--;
+	live_bytes -= data_size(buffer);
 	if (buffer->cairo) {
 		cairo_destroy(buffer->cairo);
 	}
@@ -102,6 +114,8 @@ buffer_adopt_cairo_surface(cairo_surface_t *surface)
 	buffer->logical_width = width;
 	buffer->logical_height = height;
 
+	live_count++;
+	live_bytes += data_size(buffer);
 	return buffer;
 }
 
@@ -198,5 +212,24 @@ buffer_create_from_data(void *pixel_data, uint32_t width, uint32_t height,
 	buffer->data = pixel_data;
 	buffer->format = DRM_FORMAT_ARGB8888;
 	buffer->stride = stride;
+
+	live_count++;
+	live_bytes += data_size(buffer);
 	return buffer;
 }
+
+struct lab_data_buffer *
+buffer_try_from_wlr_buffer(struct wlr_buffer *buffer)
+{
+	if (!buffer || buffer->impl != &data_buffer_impl) {
+		return NULL;
+	}
+	return (struct lab_data_buffer *)buffer;
+}
+
+void
+buffer_get_stats(size_t *count, size_t *bytes)
+{
+	*count = live_count;
+	*bytes = live_bytes;
+}
@@ -1,4 +1,8 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include "common/file-helpers.h"
 
@@ -8,3 +12,57 @@ file_exists(const char *filename)
 	struct stat st;
 	return (!stat(filename, &st));
 }
+
+/* 64-bit FNV-1a */
+static uint64_t
+hash_bytes(uint64_t hash, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+	for (size_t i = 0; i < len; i++) {
+		hash ^= p[i];
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+uint64_t
+file_fingerprint(uint64_t hash, const char *filename)
+{
+	hash = hash_bytes(hash, filename, strlen(filename) + 1);
+
+	struct stat st;
+	if (stat(filename, &st)) {
+		return hash;
+	}
+	/* Explicitly list members to avoid hashing struct padding */
+	uint64_t attributes[] = {
+		st.st_dev,
+		st.st_ino,
+		st.st_size,
+		st.st_mtim.tv_sec,
+		st.st_mtim.tv_nsec,
+	};
+	return hash_bytes(hash, attributes, sizeof(attributes));
+}
+
+uint64_t
+dir_fingerprint(uint64_t hash, const char *dirname)
+{
+	hash = file_fingerprint(hash, dirname);
+
+	DIR *dir = opendir(dirname);
+	if (!dir) {
+		return hash;
+	}
+	char path[4096];
+	struct dirent *entry;
+	while ((entry = readdir(dir))) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+		snprintf(path, sizeof(path), "%s/%s", dirname, entry->d_name);
+		hash = file_fingerprint(hash, path);
+	}
+	closedir(dir);
+	return hash;
+}
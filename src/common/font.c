@@ -10,6 +10,7 @@
 #include "common/string-helpers.h"
 #include "labwc.h"
 #include "buffer.h"
+#include "trace.h"
 
 PangoFontDescription *
 font_to_pango_desc(struct font *font)
@@ -84,6 +85,7 @@ font_buffer_create(struct lab_data_buffer **buffer, int max_width,
 	const char *text, struct font *font, const float *color,
 	const float *bg_color, const char *arrow, double scale)
 {
+	TRACE_SPAN("font_buffer_create");
 	/* Allow a minimum of one pixel each for text and arrow */
 	if (max_width < 2) {
 		max_width = 2;
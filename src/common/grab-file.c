@@ -8,29 +8,65 @@
 #define _POSIX_C_SOURCE 200809L
 #include "common/grab-file.h"
 #include "common/buf.h"
+#include "common/mem.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+
+/* Used for pipes and other streams with unknown size */
+#define GRAB_CHUNK_SIZE 4096
 
 struct buf
-grab_file(const char *filename)
+grab_stream(FILE *stream)
 {
-	char *line = NULL;
+	/*
+	 * Size the buffer up front for regular files so that the whole
+	 * file can be read with a single allocation. The extra byte beyond
+	 * the NUL terminator makes the final fread() a short one so that we
+	 * hit EOF without growing the buffer.
+	 */
+	size_t alloc = GRAB_CHUNK_SIZE;
+	struct stat st;
+	if (!fstat(fileno(stream), &st) && S_ISREG(st.st_mode)) {
+		alloc = (size_t)st.st_size + 2;
+	}
+
+	char *data = xmalloc(alloc);
 	size_t len = 0;
+	while (!feof(stream) && !ferror(stream)) {
+		if (alloc - len < 2) {
+			alloc *= 2;
+			data = xrealloc(data, alloc);
+		}
+		len += fread(data + len, 1, alloc - len - 1, stream);
+	}
+
+	/* Strip newlines in place */
+	char *dst = data;
+	for (size_t i = 0; i < len; i++) {
+		if (data[i] != '\n') {
+			*dst++ = data[i];
+		}
+	}
+	*dst = '\0';
+
+	return (struct buf){
+		.data = data,
+		.alloc = alloc,
+		.len = dst - data,
+	};
+}
+
+struct buf
+grab_file(const char *filename)
+{
 	FILE *stream = fopen(filename, "r");
 	if (!stream) {
 		return BUF_INIT;
 	}
-	struct buf buffer = BUF_INIT;
-	while ((getline(&line, &len, stream) != -1)) {
-		char *p = strrchr(line, '\n');
-		if (p) {
-			*p = '\0';
-		}
-		buf_add(&buffer, line);
-	}
-	free(line);
+	struct buf buffer = grab_stream(stream);
 	fclose(stream);
 	return buffer;
 }
@@ -1,10 +1,236 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include <assert.h>
 #include <fnmatch.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include "common/match.h"
+#include "common/mem.h"
+
+/* The NFA has one state per token plus the final one, see struct nfa */
+#define NFA_MAX_TOKENS 63
+
+enum match_type {
+	MATCH_FNMATCH = 0,	/* syntax not handled here */
+	MATCH_ANY,		/* "*" */
+	MATCH_LITERAL,		/* "foo" */
+	MATCH_PREFIX,		/* "foo*" */
+	MATCH_SUFFIX,		/* "*foo" */
+	MATCH_INFIX,		/* "*foo*" */
+	MATCH_NFA,		/* any other combination of '*' and '?' */
+};
+
+/*
+ * Bit i of a state set means that the first i tokens of the pattern have
+ * matched. Consecutive stars are collapsed when compiling, so a single
+ * shift is enough to let a star match the empty string.
+ */
+struct nfa {
+	uint64_t star_mask;	/* tokens which are '*' */
+	uint64_t joker_mask;	/* tokens which are '?' */
+	uint64_t accept;	/* state after the last token */
+	/* Index into char_masks for each lower case char, 0 if unused */
+	uint8_t char_index[128];
+	uint64_t char_masks[NFA_MAX_TOKENS + 1];
+};
+
+struct match_pattern {
+	enum match_type type;
+	char *source;
+	/* Lower case literal part of the pattern for the fast paths */
+	char *literal;
+	size_t literal_len;
+	struct nfa *nfa;
+};
 
 bool
 match_glob(const char *pattern, const char *string)
 {
 	return fnmatch(pattern, string, FNM_CASEFOLD) == 0;
 }
+
+static inline unsigned char
+fold(unsigned char c)
+{
+	return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+static struct nfa *
+nfa_create(const char *tokens, size_t len)
+{
+	assert(len <= NFA_MAX_TOKENS);
+	struct nfa *nfa = znew(*nfa);
+	uint8_t nr_chars = 1;
+	for (size_t i = 0; i < len; i++) {
+		uint64_t bit = (uint64_t)1 << i;
+		unsigned char c = tokens[i];
+		if (c == '*') {
+			nfa->star_mask |= bit;
+		} else if (c == '?') {
+			nfa->joker_mask |= bit;
+		} else {
+			if (!nfa->char_index[c]) {
+				nfa->char_index[c] = nr_chars++;
+			}
+			nfa->char_masks[nfa->char_index[c]] |= bit;
+		}
+	}
+	nfa->accept = (uint64_t)1 << len;
+	return nfa;
+}
+
+static uint64_t
+nfa_closure(const struct nfa *nfa, uint64_t states)
+{
+	return states | ((states & nfa->star_mask) << 1);
+}
+
+static bool
+nfa_match(const struct match_pattern *pattern, const char *string)
+{
+	const struct nfa *nfa = pattern->nfa;
+	uint64_t states = nfa_closure(nfa, 1);
+	for (const unsigned char *s = (const unsigned char *)string; *s; s++) {
+		uint64_t accepts = nfa->joker_mask;
+		if (*s < 128) {
+			accepts |= nfa->char_masks[nfa->char_index[fold(*s)]];
+		} else if (nfa->joker_mask) {
+			/* fnmatch() lets '?' match a whole multibyte character */
+			return match_glob(pattern->source, string);
+		}
+		states = ((states & accepts) << 1) | (states & nfa->star_mask);
+		states = nfa_closure(nfa, states);
+		if (!states) {
+			return false;
+		}
+	}
+	return states & nfa->accept;
+}
+
+struct match_pattern *
+match_pattern_create(const char *pattern)
+{
+	assert(pattern);
+	struct match_pattern *p = znew(*p);
+	p->source = xstrdup(pattern);
+
+	char *tokens = xzalloc(strlen(pattern) + 1);
+	size_t len = 0, nr_stars = 0, nr_jokers = 0;
+	for (const unsigned char *c = (const unsigned char *)pattern; *c; c++) {
+		if (*c == '[' || *c == '\\' || *c >= 128) {
+			/* Bracket expressions, escapes or multibyte characters */
+			free(tokens);
+			return p;
+		}
+		if (*c == '*') {
+			if (len && tokens[len - 1] == '*') {
+				continue;
+			}
+			nr_stars++;
+		} else if (*c == '?') {
+			nr_jokers++;
+		}
+		tokens[len++] = fold(*c);
+	}
+
+	bool leading_star = len && tokens[0] == '*';
+	bool trailing_star = len && tokens[len - 1] == '*';
+
+	if (nr_jokers) {
+		if (len > NFA_MAX_TOKENS) {
+			free(tokens);
+			return p;
+		}
+		p->type = MATCH_NFA;
+	} else if (!nr_stars) {
+		p->type = MATCH_LITERAL;
+	} else if (len == 1) {
+		p->type = MATCH_ANY;
+	} else if (nr_stars == 1 && trailing_star) {
+		p->type = MATCH_PREFIX;
+	} else if (nr_stars == 1 && leading_star) {
+		p->type = MATCH_SUFFIX;
+	} else if (nr_stars == 2 && leading_star && trailing_star) {
+		p->type = MATCH_INFIX;
+	} else if (len <= NFA_MAX_TOKENS) {
+		p->type = MATCH_NFA;
+	} else {
+		free(tokens);
+		return p;
+	}
+
+	if (p->type == MATCH_NFA) {
+		p->nfa = nfa_create(tokens, len);
+		free(tokens);
+		return p;
+	}
+
+	/* Strip the stars off the literal part */
+	if (trailing_star) {
+		tokens[--len] = '\0';
+	}
+	if (leading_star) {
+		memmove(tokens, tokens + 1, len--);
+	}
+	p->literal = tokens;
+	p->literal_len = len;
+	return p;
+}
+
+/* @lower must not contain '\0' in its first @len bytes */
+static bool
+equal_folded(const char *lower, const char *string, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (lower[i] != fold(string[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool
+match_pattern(const struct match_pattern *pattern, const char *string)
+{
+	assert(pattern);
+	const char *literal = pattern->literal;
+	size_t len = pattern->literal_len;
+
+	switch (pattern->type) {
+	case MATCH_ANY:
+		return true;
+	case MATCH_LITERAL:
+		return equal_folded(literal, string, len) && !string[len];
+	case MATCH_PREFIX:
+		return equal_folded(literal, string, len);
+	case MATCH_SUFFIX: {
+		size_t string_len = strlen(string);
+		return string_len >= len
+			&& equal_folded(literal, string + string_len - len, len);
+	}
+	case MATCH_INFIX:
+		for (const char *s = string; *s; s++) {
+			if (equal_folded(literal, s, len)) {
+				return true;
+			}
+		}
+		return false;
+	case MATCH_NFA:
+		return nfa_match(pattern, string);
+	default:
+		return match_glob(pattern->source, string);
+	}
+}
+
+void
+match_pattern_destroy(struct match_pattern *pattern)
+{
+	if (!pattern) {
+		return;
+	}
+	free(pattern->source);
+	free(pattern->literal);
+	free(pattern->nfa);
+	free(pattern);
+}
@@ -34,6 +34,8 @@
  * See wlroots/types/scene/wlr_scene.c scene_buffer_update_outputs()
  */
 
+static struct scaled_scene_buffer_stats stats;
+
 /* Internal API */
 static void
 _cache_entry_destroy(struct scaled_scene_buffer_cache_entry *cache_entry, bool drop_buffer)
@@ -47,6 +49,7 @@ _cache_entry_destroy(struct scaled_scene_buffer_cache_entry *cache_entry, bool d
 		}
 	}
 	free(cache_entry);
+	stats.cache_entries--;
 }
 
 static void
@@ -62,11 +65,13 @@ _update_buffer(struct scaled_scene_buffer *self, double scale)
 			wl_list_remove(&cache_entry->link);
 			wl_list_insert(&self->cache, &cache_entry->link);
 			wlr_scene_buffer_set_buffer(self->scene_buffer, cache_entry->buffer);
+			stats.hits++;
 			return;
 		}
 	}
 
 	/* Create new buffer, will get destroyed along the backing wlr_buffer */
+	stats.misses++;
 	struct lab_data_buffer *buffer = self->impl->create_buffer(self, scale);
 	if (buffer) {
 		/* Ensure the buffer doesn't get deleted behind our back */
@@ -78,6 +83,7 @@ _update_buffer(struct scaled_scene_buffer *self, double scale)
 	/* Create or reuse cache entry */
 	if (wl_list_length(&self->cache) < LAB_SCALED_BUFFER_MAX_CACHE) {
 		cache_entry = znew(*cache_entry);
+		stats.cache_entries++;
 	} else {
 		cache_entry = wl_container_of(self->cache.prev, cache_entry, link);
 		if (cache_entry->buffer) {
@@ -120,6 +126,7 @@ _handle_node_destroy(struct wl_listener *listener, void *data)
 		self->impl->destroy(self);
 	}
 	free(self);
+	stats.instances--;
 }
 
 static void
@@ -188,6 +195,7 @@ scaled_scene_buffer_create(struct wlr_scene_tree *parent,
 	self->destroy.notify = _handle_node_destroy;
 	wl_signal_add(&self->scene_buffer->node.events.destroy, &self->destroy);
 
+	stats.instances++;
 	return self;
 }
 
@@ -202,3 +210,10 @@ scaled_scene_buffer_invalidate_cache(struct scaled_scene_buffer *self)
 	assert(wl_list_empty(&self->cache));
 	_update_buffer(self, self->active_scale);
 }
+
+void
+scaled_scene_buffer_get_stats(struct scaled_scene_buffer_stats *out)
+{
+	assert(out);
+	*out = stats;
+}
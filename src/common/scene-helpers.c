@@ -1,12 +1,14 @@
 // SPDX-License-Identifier: GPL-2.0-only
-
+#define _POSIX_C_SOURCE 200809L
 #include <assert.h>
+#include <time.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/util/log.h>
 #include <wlr/util/region.h>
 #include <wlr/util/transform.h>
 #include "common/scene-helpers.h"
+#include "frame-stats.h"
 #include "labwc.h"
 #include "magnifier.h"
 #include "output-state.h"
@@ -88,6 +90,7 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 	assert(state);
 	struct wlr_output *wlr_output = scene_output->output;
 	struct output *output = wlr_output->data;
+	struct frame_stats *stats = output->frame_stats;
 	bool wants_magnification = output_wants_magnification(output);
 
 	/*
@@ -98,26 +101,41 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 	 */
 	if (!wlr_output->needs_frame && !pixman_region32_not_empty(
 			&scene_output->pending_commit_damage) && !wants_magnification) {
+		frame_stats_inc(stats, LAB_FRAME_COUNTER_SKIPPED);
 		return true;
 	}
 
+	struct timespec lap;
+	clock_gettime(CLOCK_MONOTONIC, &lap);
+
 	if (!wlr_scene_output_build_state(scene_output, state, NULL)) {
 		wlr_log(WLR_ERROR, "Failed to build output state for %s",
 			wlr_output->name);
+		frame_stats_inc(stats, LAB_FRAME_COUNTER_FAILED);
 		return false;
 	}
+	frame_stats_lap(stats, LAB_FRAME_STAT_BUILD_STATE, &lap);
+	/*
+	 * scene_output->prev_scanout is private wlroots state, set by
+	 * wlr_scene_output_build_state() when it chose direct scanout.
+	 */
+	frame_stats_inc(stats, scene_output->prev_scanout
+		? LAB_FRAME_COUNTER_SCANOUT : LAB_FRAME_COUNTER_COMPOSITED);
 
 	if (state->tearing_page_flip) {
 		if (!wlr_output_test_state(wlr_output, state)) {
 			state->tearing_page_flip = false;
 		}
+		frame_stats_lap(stats, LAB_FRAME_STAT_TEARING_TEST, &lap);
 	}
 
 	struct wlr_box additional_damage = {0};
 	if (state->buffer && is_magnify_on()) {
 		magnify(output, state->buffer, &additional_damage);
+		frame_stats_lap(stats, LAB_FRAME_STAT_MAGNIFY, &lap);
 	}
 
+	frame_stats_commit_begin(stats, wlr_output->commit_seq + 1);
 	bool committed = wlr_output_commit_state(wlr_output, state);
 	/*
 	 * Handle case where the ouput state test for tearing succeeded,
@@ -128,6 +146,8 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 		committed = wlr_output_commit_state(wlr_output, state);
 	}
 	if (committed) {
+		frame_stats_lap(stats, LAB_FRAME_STAT_COMMIT, &lap);
+		frame_stats_frame_committed(stats);
 		if (state == &output->pending) {
 			wlr_output_state_finish(&output->pending);
 			wlr_output_state_init(&output->pending);
@@ -135,6 +155,8 @@ lab_wlr_scene_output_commit(struct wlr_scene_output *scene_output,
 	} else {
 		wlr_log(WLR_INFO, "Failed to commit output %s",
 			wlr_output->name);
+		frame_stats_inc(stats, LAB_FRAME_COUNTER_FAILED);
+		frame_stats_commit_failed(stats);
 		return false;
 	}
 
@@ -12,6 +12,96 @@
 #include "config/rcxml.h"
 #include "labwc.h"
 
+/*
+ * Keybinds by (modifiers, keysym) and (modifiers, keycode). The values
+ * are arrays of struct keybind pointers in rc.keybinds order so that the
+ * first matching keybind still takes precedence.
+ */
+static GHashTable *keysym_index;
+static GHashTable *keycode_index;
+
+static gint64 *
+index_key(uint32_t modifiers, uint32_t value)
+{
+	gint64 *key = g_new(gint64, 1);
+	*key = (gint64)((uint64_t)modifiers << 32 | value);
+	return key;
+}
+
+static void
+index_value_free(gpointer data)
+{
+	struct wl_array *keybinds = data;
+	wl_array_release(keybinds);
+	free(keybinds);
+}
+
+static void
+index_add(GHashTable *index, uint32_t modifiers, uint32_t value,
+		struct keybind *keybind)
+{
+	gint64 *key = index_key(modifiers, value);
+	struct wl_array *keybinds = g_hash_table_lookup(index, key);
+	if (!keybinds) {
+		keybinds = znew(*keybinds);
+		wl_array_init(keybinds);
+		g_hash_table_insert(index, key, keybinds);
+	} else {
+		g_free(key);
+		/* A keybind may contain the same key more than once */
+		struct keybind **entries = keybinds->data;
+		size_t len = keybinds->size / sizeof(*entries);
+		if (entries[len - 1] == keybind) {
+			return;
+		}
+	}
+	struct keybind **entry = wl_array_add(keybinds, sizeof(*entry));
+	*entry = keybind;
+}
+
+void
+keybind_index_finish(void)
+{
+	g_clear_pointer(&keysym_index, g_hash_table_destroy);
+	g_clear_pointer(&keycode_index, g_hash_table_destroy);
+}
+
+void
+keybind_index_rebuild(void)
+{
+	keybind_index_finish();
+	keysym_index = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+		g_free, index_value_free);
+	keycode_index = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+		g_free, index_value_free);
+
+	struct keybind *keybind;
+	wl_list_for_each(keybind, &rc.keybinds, link) {
+		for (size_t i = 0; i < keybind->keysyms_len; i++) {
+			index_add(keysym_index, keybind->modifiers,
+				keybind->keysyms[i], keybind);
+		}
+		for (size_t i = 0; i < keybind->keycodes_len; i++) {
+			index_add(keycode_index, keybind->modifiers,
+				keybind->keycodes[i], keybind);
+		}
+	}
+}
+
+struct wl_array *
+keybind_index_lookup(uint32_t modifiers, xkb_keysym_t sym,
+		xkb_keycode_t keycode)
+{
+	GHashTable *index = sym == XKB_KEY_NoSymbol ? keycode_index : keysym_index;
+	if (!index) {
+		return NULL;
+	}
+	/* Keybind keysyms are stored in lower case, see keybind_create() */
+	gint64 key = (gint64)((uint64_t)modifiers << 32
+		| (sym == XKB_KEY_NoSymbol ? keycode : xkb_keysym_to_lower(sym)));
+	return g_hash_table_lookup(index, &key);
+}
+
 uint32_t
 parse_modifier(const char *symname)
 {
@@ -113,6 +203,7 @@ keybind_update_keycodes(struct server *server)
 		wlr_log(WLR_DEBUG, "Found layout %s", xkb_keymap_layout_get_name(keymap, i));
 		xkb_keymap_key_for_each(keymap, update_keycodes_iter, &i);
 	}
+	keybind_index_rebuild();
 }
 
 struct keybind *
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
+#include <glib.h>
 #include <linux/input-event-codes.h>
 #include <strings.h>
 #include <unistd.h>
@@ -10,6 +11,14 @@
 #include "config/mousebind.h"
 #include "config/rcxml.h"
 
+/* Keeps scroll directions apart from buttons in the index */
+#define SCROLL_KEY 0x80000000u
+
+static_assert(LAB_SSD_END_MARKER <= 64, "context_mask is too small");
+
+/* Mousebinds by (modifiers, button or SCROLL_KEY | direction) */
+static GHashTable *mousebind_index;
+
 uint32_t
 mousebind_button_from_str(const char *str, uint32_t *modifiers)
 {
@@ -181,3 +190,91 @@ mousebind_create(const char *context)
 	wl_list_init(&m->actions);
 	return m;
 }
+
+static gint64
+index_key(uint32_t modifiers, uint32_t value)
+{
+	return (gint64)((uint64_t)modifiers << 32 | value);
+}
+
+static void
+index_value_free(gpointer data)
+{
+	struct wl_array *mousebinds = data;
+	wl_array_release(mousebinds);
+	free(mousebinds);
+}
+
+static void
+index_add(uint32_t modifiers, uint32_t value, struct mousebind *mousebind)
+{
+	gint64 key = index_key(modifiers, value);
+	struct wl_array *mousebinds = g_hash_table_lookup(mousebind_index, &key);
+	if (!mousebinds) {
+		mousebinds = znew(*mousebinds);
+		wl_array_init(mousebinds);
+		gint64 *stored_key = g_new(gint64, 1);
+		*stored_key = key;
+		g_hash_table_insert(mousebind_index, stored_key, mousebinds);
+	}
+	struct mousebind **entry = wl_array_add(mousebinds, sizeof(*entry));
+	*entry = mousebind;
+}
+
+void
+mousebind_index_finish(void)
+{
+	g_clear_pointer(&mousebind_index, g_hash_table_destroy);
+}
+
+void
+mousebind_index_rebuild(void)
+{
+	mousebind_index_finish();
+	mousebind_index = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+		g_free, index_value_free);
+
+	struct mousebind *m;
+	wl_list_for_each(m, &rc.mousebinds, link) {
+		m->context_mask = 0;
+		for (int type = 0; type < LAB_SSD_END_MARKER; type++) {
+			if (ssd_part_contains(m->context, type)) {
+				m->context_mask |= 1ull << type;
+			}
+		}
+		if (m->mouse_event == MOUSE_ACTION_SCROLL) {
+			index_add(m->modifiers, SCROLL_KEY | m->direction, m);
+		} else {
+			index_add(m->modifiers, m->button, m);
+		}
+	}
+}
+
+static struct wl_array *
+index_lookup(uint32_t modifiers, uint32_t value)
+{
+	if (!mousebind_index) {
+		return NULL;
+	}
+	gint64 key = index_key(modifiers, value);
+	return g_hash_table_lookup(mousebind_index, &key);
+}
+
+struct wl_array *
+mousebind_index_lookup_button(uint32_t modifiers, uint32_t button)
+{
+	return index_lookup(modifiers, button);
+}
+
+struct wl_array *
+mousebind_index_lookup_scroll(uint32_t modifiers, enum direction direction)
+{
+	return index_lookup(modifiers, SCROLL_KEY | direction);
+}
+
+bool
+mousebind_in_context(struct mousebind *mousebind, enum ssd_part_type type)
+{
+	return type < LAB_SSD_END_MARKER
+		&& (mousebind->context_mask & (1ull << type));
+}
@@ -10,14 +10,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
 #include <unistd.h>
 #include <wayland-server-core.h>
 #include <wlr/util/box.h>
 #include <wlr/util/log.h>
 #include "action.h"
 #include "common/dir.h"
+#include "common/grab-file.h"
 #include "common/list.h"
 #include "common/macros.h"
+#include "common/match.h"
 #include "common/mem.h"
 #include "common/nodename.h"
 #include "common/parse-bool.h"
@@ -301,6 +304,14 @@ set_property(const char *str, enum property *variable)
 	*variable = ret ? LAB_PROP_TRUE : LAB_PROP_FALSE;
 }
 
+/* Patterns are compiled once here rather than on every match */
+static void
+set_pattern(struct match_pattern **pattern, const char *content)
+{
+	match_pattern_destroy(*pattern);
+	*pattern = match_pattern_create(content);
+}
+
 static void
 fill_window_rule(char *nodename, char *content)
 {
@@ -320,21 +331,17 @@ fill_window_rule(char *nodename, char *content)
 
 	/* Criteria */
 	} else if (!strcmp(nodename, "identifier")) {
-		free(current_window_rule->identifier);
-		current_window_rule->identifier = xstrdup(content);
+		set_pattern(&current_window_rule->identifier, content);
 	} else if (!strcmp(nodename, "title")) {
-		free(current_window_rule->title);
-		current_window_rule->title = xstrdup(content);
+		set_pattern(&current_window_rule->title, content);
 	} else if (!strcmp(nodename, "type")) {
 		current_window_rule->window_type = parse_window_type(content);
 	} else if (!strcasecmp(nodename, "matchOnce")) {
 		set_bool(content, &current_window_rule->match_once);
 	} else if (!strcasecmp(nodename, "sandboxEngine")) {
-		free(current_window_rule->sandbox_engine);
-		current_window_rule->sandbox_engine = xstrdup(content);
+		set_pattern(&current_window_rule->sandbox_engine, content);
 	} else if (!strcasecmp(nodename, "sandboxAppId")) {
-		free(current_window_rule->sandbox_app_id);
-		current_window_rule->sandbox_app_id = xstrdup(content);
+		set_pattern(&current_window_rule->sandbox_app_id, content);
 
 	/* Event */
 	} else if (!strcmp(nodename, "event")) {
@@ -464,15 +471,15 @@ fill_action_query(char *nodename, char *content, struct action *action)
 	}
 
 	if (!strcasecmp(nodename, "identifier")) {
-		current_view_query->identifier = xstrdup(content);
+		set_pattern(&current_view_query->identifier, content);
 	} else if (!strcasecmp(nodename, "title")) {
-		current_view_query->title = xstrdup(content);
+		set_pattern(&current_view_query->title, content);
 	} else if (!strcmp(nodename, "type")) {
 		current_view_query->window_type = parse_window_type(content);
 	} else if (!strcasecmp(nodename, "sandboxEngine")) {
-		current_view_query->sandbox_engine = xstrdup(content);
+		set_pattern(&current_view_query->sandbox_engine, content);
 	} else if (!strcasecmp(nodename, "sandboxAppId")) {
-		current_view_query->sandbox_app_id = xstrdup(content);
+		set_pattern(&current_view_query->sandbox_app_id, content);
 	} else if (!strcasecmp(nodename, "shaded")) {
 		current_view_query->shaded = parse_three_state(content);
 	} else if (!strcasecmp(nodename, "maximized")) {
@@ -486,7 +493,7 @@ fill_action_query(char *nodename, char *content, struct action *action)
 	} else if (!strcasecmp(nodename, "tiled")) {
 		current_view_query->tiled = view_edge_parse(content);
 	} else if (!strcasecmp(nodename, "tiled_region")) {
-		current_view_query->tiled_region = xstrdup(content);
+		set_pattern(&current_view_query->tiled_region, content);
 	} else if (!strcasecmp(nodename, "desktop")) {
 		current_view_query->desktop = xstrdup(content);
 	} else if (!strcasecmp(nodename, "decoration")) {
@@ -961,6 +968,260 @@ set_tearing_mode(const char *str, enum tearing_mode *variable)
 	}
 }
 
+static void
+set_modifier_broadcast_mode(const char *str,
+		enum modifier_broadcast_mode *variable)
+{
+	if (!strcasecmp(str, "all")) {
+		*variable = LAB_MODIFIER_BROADCAST_ALL;
+	} else if (!strcasecmp(str, "pointer")) {
+		*variable = LAB_MODIFIER_BROADCAST_POINTER;
+	} else if (!strcasecmp(str, "none")) {
+		*variable = LAB_MODIFIER_BROADCAST_NONE;
+	} else {
+		wlr_log(WLR_ERROR, "invalid modifierBroadcast value '%s'", str);
+	}
+}
+
+/*
+ * Settings which are fully identified by their nodename. entry() looks
+ * them up in node_index rather than comparing the nodename against each
+ * of them in turn. Nodes which depend on parse state, like those within
+ * <keybind> or <windowRules>, are handled before the lookup.
+ */
+enum rc_node {
+	RC_NODE_UNKNOWN = 0,
+	RC_NODE_PLACE_FONT_THEME,
+	RC_NODE_DECORATION_CORE,
+	RC_NODE_GAP_CORE,
+	RC_NODE_ADAPTIVE_SYNC_CORE,
+	RC_NODE_ALLOW_TEARING_CORE,
+	RC_NODE_REUSE_OUTPUT_MODE_CORE,
+	RC_NODE_LATENCY_PROBE_CORE,
+	RC_NODE_HIDDEN_FRAME_RATE_CORE,
+	RC_NODE_INACTIVE_FRAME_RATE_CORE,
+	RC_NODE_POLICY_PLACEMENT,
+	RC_NODE_XWAYLAND_PERSISTENCE_CORE,
+	RC_NODE_X_CASCADE_OFFSET_PLACEMENT,
+	RC_NODE_Y_CASCADE_OFFSET_PLACEMENT,
+	RC_NODE_NAME_THEME,
+	RC_NODE_ICON_THEME,
+	RC_NODE_LAYOUT_TITLEBAR_THEME,
+	RC_NODE_SHOW_TITLE_TITLEBAR_THEME,
+	RC_NODE_CORNERRADIUS_THEME,
+	RC_NODE_KEEP_BORDER_THEME,
+	RC_NODE_DROP_SHADOWS_THEME,
+	RC_NODE_FONT_THEME,
+	RC_NODE_FOLLOW_MOUSE_FOCUS,
+	RC_NODE_FOLLOW_MOUSE_REQUIRES_MOVEMENT_FOCUS,
+	RC_NODE_RAISE_ON_FOCUS_FOCUS,
+	RC_NODE_DEFER_MAP_FOCUS_FOCUS,
+	RC_NODE_DOUBLE_CLICK_TIME_MOUSE,
+	RC_NODE_SCROLL_FACTOR_MOUSE,
+	RC_NODE_NAME_CONTEXT_MOUSE,
+	RC_NODE_REPEAT_RATE_KEYBOARD,
+	RC_NODE_REPEAT_DELAY_KEYBOARD,
+	RC_NODE_NUMLOCK_KEYBOARD,
+	RC_NODE_LAYOUT_SCOPE_KEYBOARD,
+	RC_NODE_MODIFIER_BROADCAST_KEYBOARD,
+	RC_NODE_SCREEN_EDGE_STRENGTH_RESISTANCE,
+	RC_NODE_WINDOW_EDGE_STRENGTH_RESISTANCE,
+	RC_NODE_UN_SNAP_THRESHOLD_RESISTANCE,
+	RC_NODE_UN_MAXIMIZE_THRESHOLD_RESISTANCE,
+	RC_NODE_RANGE_SNAPPING,
+	RC_NODE_ENABLED_OVERLAY_SNAPPING,
+	RC_NODE_INNER_DELAY_OVERLAY_SNAPPING,
+	RC_NODE_OUTER_DELAY_OVERLAY_SNAPPING,
+	RC_NODE_TOP_MAXIMIZE_SNAPPING,
+	RC_NODE_NOTIFY_CLIENT_SNAPPING,
+	RC_NODE_SHOW_WINDOW_SWITCHER,
+	RC_NODE_PREVIEW_WINDOW_SWITCHER,
+	RC_NODE_OUTLINES_WINDOW_SWITCHER,
+	RC_NODE_ALL_WORKSPACES_WINDOW_SWITCHER,
+	RC_NODE_CYCLE_VIEW_OSD_CORE,
+	RC_NODE_CYCLE_VIEW_PREVIEW_CORE,
+	RC_NODE_CYCLE_VIEW_OUTLINES_CORE,
+	RC_NODE_NAME_NAMES_DESKTOPS,
+	RC_NODE_POPUP_TIME_DESKTOPS,
+	RC_NODE_NUMBER_DESKTOPS,
+	RC_NODE_PREFIX_DESKTOPS,
+	RC_NODE_POPUP_SHOW_RESIZE,
+	RC_NODE_DRAW_CONTENTS_RESIZE,
+	RC_NODE_MOUSE_EMULATION_TABLET,
+	RC_NODE_MAP_TO_OUTPUT_TABLET,
+	RC_NODE_ROTATE_TABLET,
+	RC_NODE_LEFT_AREA_TABLET,
+	RC_NODE_TOP_AREA_TABLET,
+	RC_NODE_WIDTH_AREA_TABLET,
+	RC_NODE_HEIGHT_AREA_TABLET,
+	RC_NODE_BUTTON_MAP_TABLET,
+	RC_NODE_TO_MAP_TABLET,
+	RC_NODE_MOTION_TABLET_TOOL,
+	RC_NODE_RELATIVE_MOTION_SENSITIVITY_TABLET_TOOL,
+	RC_NODE_IGNORE_BUTTON_RELEASE_PERIOD_MENU,
+	RC_NODE_WIDTH_MAGNIFIER,
+	RC_NODE_HEIGHT_MAGNIFIER,
+	RC_NODE_INIT_SCALE_MAGNIFIER,
+	RC_NODE_INCREMENT_MAGNIFIER,
+	RC_NODE_USE_FILTER_MAGNIFIER,
+};
+
+static const struct {
+	const char *name;
+	enum rc_node node;
+} rc_nodes[] = {
+	{ "place.font.theme", RC_NODE_PLACE_FONT_THEME },
+	{ "decoration.core", RC_NODE_DECORATION_CORE },
+	{ "gap.core", RC_NODE_GAP_CORE },
+	{ "adaptiveSync.core", RC_NODE_ADAPTIVE_SYNC_CORE },
+	{ "allowTearing.core", RC_NODE_ALLOW_TEARING_CORE },
+	{ "reuseOutputMode.core", RC_NODE_REUSE_OUTPUT_MODE_CORE },
+	{ "latencyProbe.core", RC_NODE_LATENCY_PROBE_CORE },
+	{ "hiddenFrameRate.core", RC_NODE_HIDDEN_FRAME_RATE_CORE },
+	{ "inactiveFrameRate.core", RC_NODE_INACTIVE_FRAME_RATE_CORE },
+	{ "policy.placement", RC_NODE_POLICY_PLACEMENT },
+	{ "xwaylandPersistence.core", RC_NODE_XWAYLAND_PERSISTENCE_CORE },
+	{ "x.cascadeOffset.placement", RC_NODE_X_CASCADE_OFFSET_PLACEMENT },
+	{ "y.cascadeOffset.placement", RC_NODE_Y_CASCADE_OFFSET_PLACEMENT },
+	{ "name.theme", RC_NODE_NAME_THEME },
+	{ "icon.theme", RC_NODE_ICON_THEME },
+	{ "layout.titlebar.theme", RC_NODE_LAYOUT_TITLEBAR_THEME },
+	{ "showTitle.titlebar.theme", RC_NODE_SHOW_TITLE_TITLEBAR_THEME },
+	{ "cornerradius.theme", RC_NODE_CORNERRADIUS_THEME },
+	{ "keepBorder.theme", RC_NODE_KEEP_BORDER_THEME },
+	{ "dropShadows.theme", RC_NODE_DROP_SHADOWS_THEME },
+	{ "name.font.theme", RC_NODE_FONT_THEME },
+	{ "size.font.theme", RC_NODE_FONT_THEME },
+	{ "slant.font.theme", RC_NODE_FONT_THEME },
+	{ "weight.font.theme", RC_NODE_FONT_THEME },
+	{ "followMouse.focus", RC_NODE_FOLLOW_MOUSE_FOCUS },
+	{ "followMouseRequiresMovement.focus", RC_NODE_FOLLOW_MOUSE_REQUIRES_MOVEMENT_FOCUS },
+	{ "raiseOnFocus.focus", RC_NODE_RAISE_ON_FOCUS_FOCUS },
+	{ "deferMapFocus.focus", RC_NODE_DEFER_MAP_FOCUS_FOCUS },
+	{ "doubleClickTime.mouse", RC_NODE_DOUBLE_CLICK_TIME_MOUSE },
+	{ "scrollFactor.mouse", RC_NODE_SCROLL_FACTOR_MOUSE },
+	{ "name.context.mouse", RC_NODE_NAME_CONTEXT_MOUSE },
+	{ "repeatRate.keyboard", RC_NODE_REPEAT_RATE_KEYBOARD },
+	{ "repeatDelay.keyboard", RC_NODE_REPEAT_DELAY_KEYBOARD },
+	{ "numlock.keyboard", RC_NODE_NUMLOCK_KEYBOARD },
+	{ "layoutScope.keyboard", RC_NODE_LAYOUT_SCOPE_KEYBOARD },
+	{ "modifierBroadcast.keyboard", RC_NODE_MODIFIER_BROADCAST_KEYBOARD },
+	{ "screenEdgeStrength.resistance", RC_NODE_SCREEN_EDGE_STRENGTH_RESISTANCE },
+	{ "windowEdgeStrength.resistance", RC_NODE_WINDOW_EDGE_STRENGTH_RESISTANCE },
+	{ "unSnapThreshold.resistance", RC_NODE_UN_SNAP_THRESHOLD_RESISTANCE },
+	{ "unMaximizeThreshold.resistance", RC_NODE_UN_MAXIMIZE_THRESHOLD_RESISTANCE },
+	{ "range.snapping", RC_NODE_RANGE_SNAPPING },
+	{ "enabled.overlay.snapping", RC_NODE_ENABLED_OVERLAY_SNAPPING },
+	{ "inner.delay.overlay.snapping", RC_NODE_INNER_DELAY_OVERLAY_SNAPPING },
+	{ "outer.delay.overlay.snapping", RC_NODE_OUTER_DELAY_OVERLAY_SNAPPING },
+	{ "topMaximize.snapping", RC_NODE_TOP_MAXIMIZE_SNAPPING },
+	{ "notifyClient.snapping", RC_NODE_NOTIFY_CLIENT_SNAPPING },
+	{ "show.windowSwitcher", RC_NODE_SHOW_WINDOW_SWITCHER },
+	{ "preview.windowSwitcher", RC_NODE_PREVIEW_WINDOW_SWITCHER },
+	{ "outlines.windowSwitcher", RC_NODE_OUTLINES_WINDOW_SWITCHER },
+	{ "allWorkspaces.windowSwitcher", RC_NODE_ALL_WORKSPACES_WINDOW_SWITCHER },
+	{ "cycleViewOSD.core", RC_NODE_CYCLE_VIEW_OSD_CORE },
+	{ "cycleViewPreview.core", RC_NODE_CYCLE_VIEW_PREVIEW_CORE },
+	{ "cycleViewOutlines.core", RC_NODE_CYCLE_VIEW_OUTLINES_CORE },
+	{ "name.names.desktops", RC_NODE_NAME_NAMES_DESKTOPS },
+	{ "popupTime.desktops", RC_NODE_POPUP_TIME_DESKTOPS },
+	{ "number.desktops", RC_NODE_NUMBER_DESKTOPS },
+	{ "prefix.desktops", RC_NODE_PREFIX_DESKTOPS },
+	{ "popupShow.resize", RC_NODE_POPUP_SHOW_RESIZE },
+	{ "drawContents.resize", RC_NODE_DRAW_CONTENTS_RESIZE },
+	{ "mouseEmulation.tablet", RC_NODE_MOUSE_EMULATION_TABLET },
+	{ "mapToOutput.tablet", RC_NODE_MAP_TO_OUTPUT_TABLET },
+	{ "rotate.tablet", RC_NODE_ROTATE_TABLET },
+	{ "left.area.tablet", RC_NODE_LEFT_AREA_TABLET },
+	{ "top.area.tablet", RC_NODE_TOP_AREA_TABLET },
+	{ "width.area.tablet", RC_NODE_WIDTH_AREA_TABLET },
+	{ "height.area.tablet", RC_NODE_HEIGHT_AREA_TABLET },
+	{ "button.map.tablet", RC_NODE_BUTTON_MAP_TABLET },
+	{ "to.map.tablet", RC_NODE_TO_MAP_TABLET },
+	{ "motion.tabletTool", RC_NODE_MOTION_TABLET_TOOL },
+	{ "relativeMotionSensitivity.tabletTool", RC_NODE_RELATIVE_MOTION_SENSITIVITY_TABLET_TOOL },
+	{ "ignoreButtonReleasePeriod.menu", RC_NODE_IGNORE_BUTTON_RELEASE_PERIOD_MENU },
+	{ "width.magnifier", RC_NODE_WIDTH_MAGNIFIER },
+	{ "height.magnifier", RC_NODE_HEIGHT_MAGNIFIER },
+	{ "initScale.magnifier", RC_NODE_INIT_SCALE_MAGNIFIER },
+	{ "increment.magnifier", RC_NODE_INCREMENT_MAGNIFIER },
+	{ "useFilter.magnifier", RC_NODE_USE_FILTER_MAGNIFIER },
+};
+
+/*
+ * Elements which set a context flag while their children are traversed.
+ * The flags are used by entry() to route nodes to the relevant fill_*()
+ * function.
+ */
+static const struct {
+	const char *name;
+	bool *flag;
+} contexts[] = {
+	{ "margin", &in_usable_area_override },
+	{ "keybind", &in_keybind },
+	{ "mousebind", &in_mousebind },
+	{ "touch", &in_touch },
+	{ "device", &in_libinput_category },
+	{ "regions", &in_regions },
+	{ "fields", &in_window_switcher_field },
+	{ "windowRules", &in_window_rules },
+	{ "query", &in_action_query },
+	{ "then", &in_action_then_branch },
+	{ "else", &in_action_else_branch },
+	{ "none", &in_action_none_branch },
+};
+
+static GHashTable *node_index;
+static GHashTable *context_index;
+
+/* Like g_str_hash() but ignoring ASCII case */
+static guint
+name_hash(gconstpointer key)
+{
+	guint hash = 5381;
+	for (const char *p = key; *p; p++) {
+		hash = (hash << 5) + hash + g_ascii_tolower(*p);
+	}
+	return hash;
+}
+
+static gboolean
+name_equal(gconstpointer a, gconstpointer b)
+{
+	return !g_ascii_strcasecmp(a, b);
+}
+
+static void
+node_index_init(void)
+{
+	if (node_index) {
+		return;
+	}
+	node_index = g_hash_table_new(name_hash, name_equal);
+	for (size_t i = 0; i < ARRAY_SIZE(rc_nodes); i++) {
+		g_hash_table_insert(node_index, (gpointer)rc_nodes[i].name,
+			GINT_TO_POINTER(rc_nodes[i].node));
+	}
+	context_index = g_hash_table_new(name_hash, name_equal);
+	for (size_t i = 0; i < ARRAY_SIZE(contexts); i++) {
+		g_hash_table_insert(context_index, (gpointer)contexts[i].name,
+			contexts[i].flag);
+	}
+}
+
+static void
+node_index_finish(void)
+{
+	g_clear_pointer(&node_index, g_hash_table_destroy);
+	g_clear_pointer(&context_index, g_hash_table_destroy);
+}
+
+static enum rc_node
+node_index_lookup(const char *nodename)
+{
+	return GPOINTER_TO_INT(g_hash_table_lookup(node_index, nodename));
+}
+
 static void
 entry(xmlNode *node, char *nodename, char *content)
 {
@@ -969,18 +1230,33 @@ entry(xmlNode *node, char *nodename, char *content)
 
 	static uint32_t button_map_from;
 
+	static char *should_print;
+	static bool has_run;
+
+	if (!has_run) {
+		should_print = getenv("LABWC_DEBUG_CONFIG_NODENAMES");
+		has_run = true;
+	}
+
 	if (!nodename) {
 		return;
 	}
 	string_truncate_at_pattern(nodename, ".openbox_config");
 	string_truncate_at_pattern(nodename, ".labwc_config");
 
-	if (getenv("LABWC_DEBUG_CONFIG_NODENAMES")) {
+	if (should_print) {
 		printf("%s: %s\n", nodename, content);
 	}
 
+	/*
+	 * Nodes within the sections below are fully handled by their fill_*()
+	 * functions, so return early rather than comparing them against every
+	 * nodename further down. Keybinds and mousebinds usually make up the
+	 * bulk of a config file.
+	 */
 	if (in_usable_area_override) {
 		fill_usable_area_override(nodename, content);
+		return;
 	}
 	if (in_keybind) {
 		if (in_action_query) {
@@ -998,6 +1274,7 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			fill_keybind(nodename, content);
 		}
+		return;
 	}
 	if (in_mousebind) {
 		if (in_action_query) {
@@ -1015,6 +1292,7 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			fill_mousebind(nodename, content);
 		}
+		return;
 	}
 	if (in_touch) {
 		fill_touch(nodename, content);
@@ -1057,111 +1335,163 @@ entry(xmlNode *node, char *nodename, char *content)
 	if (!content) {
 		return;
 	}
-	if (!strcmp(nodename, "place.font.theme")) {
+	switch (node_index_lookup(nodename)) {
+	case RC_NODE_UNKNOWN:
+		/* Remove this long term - just a friendly warning for now */
+		if (strstr(nodename, "windowswitcher.core")) {
+			wlr_log(WLR_ERROR,
+				"<windowSwitcher> should not be child of <core>");
+		}
+		break;
+	case RC_NODE_PLACE_FONT_THEME:
 		font_place = enum_font_place(content);
 		if (font_place == FONT_PLACE_UNKNOWN) {
 			wlr_log(WLR_ERROR, "invalid font place %s", content);
 		}
-	}
-
-	if (!strcmp(nodename, "decoration.core")) {
+		break;
+	case RC_NODE_DECORATION_CORE:
 		if (!strcmp(content, "client")) {
 			rc.xdg_shell_server_side_deco = false;
 		} else {
 			rc.xdg_shell_server_side_deco = true;
 		}
-	} else if (!strcmp(nodename, "gap.core")) {
+		break;
+	case RC_NODE_GAP_CORE:
 		rc.gap = atoi(content);
-	} else if (!strcasecmp(nodename, "adaptiveSync.core")) {
+		break;
+	case RC_NODE_ADAPTIVE_SYNC_CORE:
 		set_adaptive_sync_mode(content, &rc.adaptive_sync);
-	} else if (!strcasecmp(nodename, "allowTearing.core")) {
+		break;
+	case RC_NODE_ALLOW_TEARING_CORE:
 		set_tearing_mode(content, &rc.allow_tearing);
-	} else if (!strcasecmp(nodename, "reuseOutputMode.core")) {
+		break;
+	case RC_NODE_REUSE_OUTPUT_MODE_CORE:
 		set_bool(content, &rc.reuse_output_mode);
-	} else if (!strcmp(nodename, "policy.placement")) {
+		break;
+	case RC_NODE_LATENCY_PROBE_CORE:
+		set_bool(content, &rc.latency_probe);
+		break;
+	case RC_NODE_HIDDEN_FRAME_RATE_CORE:
+		rc.hidden_frame_rate = MAX(atoi(content), 0);
+		break;
+	case RC_NODE_INACTIVE_FRAME_RATE_CORE:
+		rc.inactive_frame_rate = MAX(atoi(content), 0);
+		break;
+	case RC_NODE_POLICY_PLACEMENT:
 		rc.placement_policy = view_placement_parse(content);
 		if (rc.placement_policy == LAB_PLACE_INVALID) {
 			rc.placement_policy = LAB_PLACE_CENTER;
 		}
-	} else if (!strcasecmp(nodename, "xwaylandPersistence.core")) {
+		break;
+	case RC_NODE_XWAYLAND_PERSISTENCE_CORE:
 		set_bool(content, &rc.xwayland_persistence);
-	} else if (!strcasecmp(nodename, "x.cascadeOffset.placement")) {
+		break;
+	case RC_NODE_X_CASCADE_OFFSET_PLACEMENT:
 		rc.placement_cascade_offset_x = atoi(content);
-	} else if (!strcasecmp(nodename, "y.cascadeOffset.placement")) {
+		break;
+	case RC_NODE_Y_CASCADE_OFFSET_PLACEMENT:
 		rc.placement_cascade_offset_y = atoi(content);
-	} else if (!strcmp(nodename, "name.theme")) {
+		break;
+	case RC_NODE_NAME_THEME:
 		rc.theme_name = xstrdup(content);
-	} else if (!strcmp(nodename, "icon.theme")) {
+		break;
+	case RC_NODE_ICON_THEME:
 		rc.icon_theme_name = xstrdup(content);
-	} else if (!strcasecmp(nodename, "layout.titlebar.theme")) {
+		break;
+	case RC_NODE_LAYOUT_TITLEBAR_THEME:
 		fill_title_layout(content);
-	} else if (!strcasecmp(nodename, "showTitle.titlebar.theme")) {
+		break;
+	case RC_NODE_SHOW_TITLE_TITLEBAR_THEME:
 		rc.show_title = parse_bool(content, true);
-	} else if (!strcmp(nodename, "cornerradius.theme")) {
+		break;
+	case RC_NODE_CORNERRADIUS_THEME:
 		rc.corner_radius = atoi(content);
-	} else if (!strcasecmp(nodename, "keepBorder.theme")) {
+		break;
+	case RC_NODE_KEEP_BORDER_THEME:
 		set_bool(content, &rc.ssd_keep_border);
-	} else if (!strcasecmp(nodename, "dropShadows.theme")) {
+		break;
+	case RC_NODE_DROP_SHADOWS_THEME:
 		set_bool(content, &rc.shadows_enabled);
-	} else if (!strcmp(nodename, "name.font.theme")) {
-		fill_font(nodename, content, font_place);
-	} else if (!strcmp(nodename, "size.font.theme")) {
-		fill_font(nodename, content, font_place);
-	} else if (!strcmp(nodename, "slant.font.theme")) {
-		fill_font(nodename, content, font_place);
-	} else if (!strcmp(nodename, "weight.font.theme")) {
+		break;
+	case RC_NODE_FONT_THEME:
 		fill_font(nodename, content, font_place);
-	} else if (!strcasecmp(nodename, "followMouse.focus")) {
+		break;
+	case RC_NODE_FOLLOW_MOUSE_FOCUS:
 		set_bool(content, &rc.focus_follow_mouse);
-	} else if (!strcasecmp(nodename, "followMouseRequiresMovement.focus")) {
+		break;
+	case RC_NODE_FOLLOW_MOUSE_REQUIRES_MOVEMENT_FOCUS:
 		set_bool(content, &rc.focus_follow_mouse_requires_movement);
-	} else if (!strcasecmp(nodename, "raiseOnFocus.focus")) {
+		break;
+	case RC_NODE_RAISE_ON_FOCUS_FOCUS:
 		set_bool(content, &rc.raise_on_focus);
-	} else if (!strcasecmp(nodename, "doubleClickTime.mouse")) {
+		break;
+	case RC_NODE_DEFER_MAP_FOCUS_FOCUS:
+		set_bool(content, &rc.defer_map_focus);
+		break;
+	case RC_NODE_DOUBLE_CLICK_TIME_MOUSE: {
 		long doubleclick_time_parsed = strtol(content, NULL, 10);
 		if (doubleclick_time_parsed > 0) {
 			rc.doubleclick_time = doubleclick_time_parsed;
 		} else {
 			wlr_log(WLR_ERROR, "invalid doubleClickTime");
 		}
-	} else if (!strcasecmp(nodename, "scrollFactor.mouse")) {
+		break;
+	}
+	case RC_NODE_SCROLL_FACTOR_MOUSE:
 		/* This is deprecated. Show an error message in post_processing() */
 		set_double(content, &mouse_scroll_factor);
-	} else if (!strcasecmp(nodename, "name.context.mouse")) {
+		break;
+	case RC_NODE_NAME_CONTEXT_MOUSE:
 		current_mouse_context = content;
 		current_mousebind = NULL;
-
-	} else if (!strcasecmp(nodename, "repeatRate.keyboard")) {
+		break;
+	case RC_NODE_REPEAT_RATE_KEYBOARD:
 		rc.repeat_rate = atoi(content);
-	} else if (!strcasecmp(nodename, "repeatDelay.keyboard")) {
+		break;
+	case RC_NODE_REPEAT_DELAY_KEYBOARD:
 		rc.repeat_delay = atoi(content);
-	} else if (!strcasecmp(nodename, "numlock.keyboard")) {
+		break;
+	case RC_NODE_NUMLOCK_KEYBOARD:
 		set_bool(content, &rc.kb_numlock_enable);
-	} else if (!strcasecmp(nodename, "layoutScope.keyboard")) {
+		break;
+	case RC_NODE_LAYOUT_SCOPE_KEYBOARD:
 		/*
 		 * This can be changed to an enum later on
 		 * if we decide to also support "application".
 		 */
 		rc.kb_layout_per_window = !strcasecmp(content, "window");
-	} else if (!strcasecmp(nodename, "screenEdgeStrength.resistance")) {
+		break;
+	case RC_NODE_MODIFIER_BROADCAST_KEYBOARD:
+		set_modifier_broadcast_mode(content, &rc.modifier_broadcast);
+		break;
+	case RC_NODE_SCREEN_EDGE_STRENGTH_RESISTANCE:
 		rc.screen_edge_strength = atoi(content);
-	} else if (!strcasecmp(nodename, "windowEdgeStrength.resistance")) {
+		break;
+	case RC_NODE_WINDOW_EDGE_STRENGTH_RESISTANCE:
 		rc.window_edge_strength = atoi(content);
-	} else if (!strcasecmp(nodename, "unSnapThreshold.resistance")) {
+		break;
+	case RC_NODE_UN_SNAP_THRESHOLD_RESISTANCE:
 		rc.unsnap_threshold = atoi(content);
-	} else if (!strcasecmp(nodename, "unMaximizeThreshold.resistance")) {
+		break;
+	case RC_NODE_UN_MAXIMIZE_THRESHOLD_RESISTANCE:
 		rc.unmaximize_threshold = atoi(content);
-	} else if (!strcasecmp(nodename, "range.snapping")) {
+		break;
+	case RC_NODE_RANGE_SNAPPING:
 		rc.snap_edge_range = atoi(content);
-	} else if (!strcasecmp(nodename, "enabled.overlay.snapping")) {
+		break;
+	case RC_NODE_ENABLED_OVERLAY_SNAPPING:
 		set_bool(content, &rc.snap_overlay_enabled);
-	} else if (!strcasecmp(nodename, "inner.delay.overlay.snapping")) {
+		break;
+	case RC_NODE_INNER_DELAY_OVERLAY_SNAPPING:
 		rc.snap_overlay_delay_inner = atoi(content);
-	} else if (!strcasecmp(nodename, "outer.delay.overlay.snapping")) {
+		break;
+	case RC_NODE_OUTER_DELAY_OVERLAY_SNAPPING:
 		rc.snap_overlay_delay_outer = atoi(content);
-	} else if (!strcasecmp(nodename, "topMaximize.snapping")) {
+		break;
+	case RC_NODE_TOP_MAXIMIZE_SNAPPING:
 		set_bool(content, &rc.snap_top_maximize);
-	} else if (!strcasecmp(nodename, "notifyClient.snapping")) {
+		break;
+	case RC_NODE_NOTIFY_CLIENT_SNAPPING:
 		if (!strcasecmp(content, "always")) {
 			rc.snap_tiling_events_mode = LAB_TILING_EVENTS_ALWAYS;
 		} else if (!strcasecmp(content, "region")) {
@@ -1173,57 +1503,54 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			wlr_log(WLR_ERROR, "ignoring invalid value for notifyClient");
 		}
-
-	/* <windowSwitcher show="" preview="" outlines="" /> */
-	} else if (!strcasecmp(nodename, "show.windowSwitcher")) {
+		break;
+	case RC_NODE_SHOW_WINDOW_SWITCHER:
 		set_bool(content, &rc.window_switcher.show);
-	} else if (!strcasecmp(nodename, "preview.windowSwitcher")) {
+		break;
+	case RC_NODE_PREVIEW_WINDOW_SWITCHER:
 		set_bool(content, &rc.window_switcher.preview);
-	} else if (!strcasecmp(nodename, "outlines.windowSwitcher")) {
+		break;
+	case RC_NODE_OUTLINES_WINDOW_SWITCHER:
 		set_bool(content, &rc.window_switcher.outlines);
-	} else if (!strcasecmp(nodename, "allWorkspaces.windowSwitcher")) {
+		break;
+	case RC_NODE_ALL_WORKSPACES_WINDOW_SWITCHER:
 		if (parse_bool(content, -1) == true) {
 			rc.window_switcher.criteria &=
 				~LAB_VIEW_CRITERIA_CURRENT_WORKSPACE;
 		}
-
-	/* Remove this long term - just a friendly warning for now */
-	} else if (strstr(nodename, "windowswitcher.core")) {
-		wlr_log(WLR_ERROR, "<windowSwitcher> should not be child of <core>");
-
-	/* The following three are for backward compatibility only */
-	} else if (!strcasecmp(nodename, "show.windowSwitcher.core")) {
-		set_bool(content, &rc.window_switcher.show);
-	} else if (!strcasecmp(nodename, "preview.windowSwitcher.core")) {
-		set_bool(content, &rc.window_switcher.preview);
-	} else if (!strcasecmp(nodename, "outlines.windowSwitcher.core")) {
-		set_bool(content, &rc.window_switcher.outlines);
-
+		break;
 	/* The following three are for backward compatibility only */
-	} else if (!strcasecmp(nodename, "cycleViewOSD.core")) {
+	case RC_NODE_CYCLE_VIEW_OSD_CORE:
 		set_bool(content, &rc.window_switcher.show);
 		wlr_log(WLR_ERROR, "<cycleViewOSD> is deprecated."
 			" Use <windowSwitcher show=\"\" />");
-	} else if (!strcasecmp(nodename, "cycleViewPreview.core")) {
+		break;
+	case RC_NODE_CYCLE_VIEW_PREVIEW_CORE:
 		set_bool(content, &rc.window_switcher.preview);
 		wlr_log(WLR_ERROR, "<cycleViewPreview> is deprecated."
 			" Use <windowSwitcher preview=\"\" />");
-	} else if (!strcasecmp(nodename, "cycleViewOutlines.core")) {
+		break;
+	case RC_NODE_CYCLE_VIEW_OUTLINES_CORE:
 		set_bool(content, &rc.window_switcher.outlines);
 		wlr_log(WLR_ERROR, "<cycleViewOutlines> is deprecated."
 			" Use <windowSwitcher outlines=\"\" />");
-
-	} else if (!strcasecmp(nodename, "name.names.desktops")) {
+		break;
+	case RC_NODE_NAME_NAMES_DESKTOPS: {
 		struct workspace *workspace = znew(*workspace);
 		workspace->name = xstrdup(content);
 		wl_list_append(&rc.workspace_config.workspaces, &workspace->link);
-	} else if (!strcasecmp(nodename, "popupTime.desktops")) {
+		break;
+	}
+	case RC_NODE_POPUP_TIME_DESKTOPS:
 		rc.workspace_config.popuptime = atoi(content);
-	} else if (!strcasecmp(nodename, "number.desktops")) {
+		break;
+	case RC_NODE_NUMBER_DESKTOPS:
 		rc.workspace_config.min_nr_workspaces = MAX(1, atoi(content));
-	} else if (!strcasecmp(nodename, "prefix.desktops")) {
+		break;
+	case RC_NODE_PREFIX_DESKTOPS:
 		rc.workspace_config.prefix = xstrdup(content);
-	} else if (!strcasecmp(nodename, "popupShow.resize")) {
+		break;
+	case RC_NODE_POPUP_SHOW_RESIZE:
 		if (!strcasecmp(content, "Always")) {
 			rc.resize_indicator = LAB_RESIZE_INDICATOR_ALWAYS;
 		} else if (!strcasecmp(content, "Never")) {
@@ -1233,25 +1560,35 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			wlr_log(WLR_ERROR, "Invalid value for <resize popupShow />");
 		}
-	} else if (!strcasecmp(nodename, "drawContents.resize")) {
+		break;
+	case RC_NODE_DRAW_CONTENTS_RESIZE:
 		set_bool(content, &rc.resize_draw_contents);
-	} else if (!strcasecmp(nodename, "mouseEmulation.tablet")) {
+		break;
+	case RC_NODE_MOUSE_EMULATION_TABLET:
 		set_bool(content, &rc.tablet.force_mouse_emulation);
-	} else if (!strcasecmp(nodename, "mapToOutput.tablet")) {
+		break;
+	case RC_NODE_MAP_TO_OUTPUT_TABLET:
 		rc.tablet.output_name = xstrdup(content);
-	} else if (!strcasecmp(nodename, "rotate.tablet")) {
+		break;
+	case RC_NODE_ROTATE_TABLET:
 		rc.tablet.rotation = tablet_parse_rotation(atoi(content));
-	} else if (!strcasecmp(nodename, "left.area.tablet")) {
+		break;
+	case RC_NODE_LEFT_AREA_TABLET:
 		rc.tablet.box.x = tablet_get_dbl_if_positive(content, "left");
-	} else if (!strcasecmp(nodename, "top.area.tablet")) {
+		break;
+	case RC_NODE_TOP_AREA_TABLET:
 		rc.tablet.box.y = tablet_get_dbl_if_positive(content, "top");
-	} else if (!strcasecmp(nodename, "width.area.tablet")) {
+		break;
+	case RC_NODE_WIDTH_AREA_TABLET:
 		rc.tablet.box.width = tablet_get_dbl_if_positive(content, "width");
-	} else if (!strcasecmp(nodename, "height.area.tablet")) {
+		break;
+	case RC_NODE_HEIGHT_AREA_TABLET:
 		rc.tablet.box.height = tablet_get_dbl_if_positive(content, "height");
-	} else if (!strcasecmp(nodename, "button.map.tablet")) {
+		break;
+	case RC_NODE_BUTTON_MAP_TABLET:
 		button_map_from = tablet_button_from_str(content);
-	} else if (!strcasecmp(nodename, "to.map.tablet")) {
+		break;
+	case RC_NODE_TO_MAP_TABLET:
 		if (button_map_from != UINT32_MAX) {
 			uint32_t button_map_to = mousebind_button_from_str(content, NULL);
 			if (button_map_to != UINT32_MAX) {
@@ -1260,23 +1597,32 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			wlr_log(WLR_ERROR, "Missing 'button' argument for tablet button mapping");
 		}
-	} else if (!strcasecmp(nodename, "motion.tabletTool")) {
+		break;
+	case RC_NODE_MOTION_TABLET_TOOL:
 		rc.tablet_tool.motion = tablet_parse_motion(content);
-	} else if (!strcasecmp(nodename, "relativeMotionSensitivity.tabletTool")) {
+		break;
+	case RC_NODE_RELATIVE_MOTION_SENSITIVITY_TABLET_TOOL:
 		rc.tablet_tool.relative_motion_sensitivity =
 			tablet_get_dbl_if_positive(content, "relativeMotionSensitivity");
-	} else if (!strcasecmp(nodename, "ignoreButtonReleasePeriod.menu")) {
+		break;
+	case RC_NODE_IGNORE_BUTTON_RELEASE_PERIOD_MENU:
 		rc.menu_ignore_button_release_period = atoi(content);
-	} else if (!strcasecmp(nodename, "width.magnifier")) {
+		break;
+	case RC_NODE_WIDTH_MAGNIFIER:
 		rc.mag_width = atoi(content);
-	} else if (!strcasecmp(nodename, "height.magnifier")) {
+		break;
+	case RC_NODE_HEIGHT_MAGNIFIER:
 		rc.mag_height = atoi(content);
-	} else if (!strcasecmp(nodename, "initScale.magnifier")) {
+		break;
+	case RC_NODE_INIT_SCALE_MAGNIFIER:
 		set_float(content, &rc.mag_scale);
-	} else if (!strcasecmp(nodename, "increment.magnifier")) {
+		break;
+	case RC_NODE_INCREMENT_MAGNIFIER:
 		set_float(content, &rc.mag_increment);
-	} else if (!strcasecmp(nodename, "useFilter.magnifier")) {
+		break;
+	case RC_NODE_USE_FILTER_MAGNIFIER:
 		set_bool(content, &rc.mag_filter);
+		break;
 	}
 }
 
@@ -1316,76 +1662,11 @@ xml_tree_walk(xmlNode *node)
 		if (!strcasecmp((char *)n->name, "comment")) {
 			continue;
 		}
-		if (!strcasecmp((char *)n->name, "margin")) {
-			in_usable_area_override = true;
-			traverse(n);
-			in_usable_area_override = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "keybind")) {
-			in_keybind = true;
+		bool *flag = g_hash_table_lookup(context_index, n->name);
+		if (flag) {
+			*flag = true;
 			traverse(n);
-			in_keybind = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "mousebind")) {
-			in_mousebind = true;
-			traverse(n);
-			in_mousebind = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "touch")) {
-			in_touch = true;
-			traverse(n);
-			in_touch = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "device")) {
-			in_libinput_category = true;
-			traverse(n);
-			in_libinput_category = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "regions")) {
-			in_regions = true;
-			traverse(n);
-			in_regions = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "fields")) {
-			in_window_switcher_field = true;
-			traverse(n);
-			in_window_switcher_field = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "windowRules")) {
-			in_window_rules = true;
-			traverse(n);
-			in_window_rules = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "query")) {
-			in_action_query = true;
-			traverse(n);
-			in_action_query = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "then")) {
-			in_action_then_branch = true;
-			traverse(n);
-			in_action_then_branch = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "else")) {
-			in_action_else_branch = true;
-			traverse(n);
-			in_action_else_branch = false;
-			continue;
-		}
-		if (!strcasecmp((char *)n->name, "none")) {
-			in_action_none_branch = true;
-			traverse(n);
-			in_action_none_branch = false;
+			*flag = false;
 			continue;
 		}
 		traverse(n);
@@ -1401,6 +1682,7 @@ rcxml_parse_xml(struct buf *b)
 		wlr_log(WLR_ERROR, "error parsing config file");
 		return;
 	}
+	node_index_init();
 	xml_tree_walk(xmlDocGetRootElement(d));
 	xmlFreeDoc(d);
 	xmlCleanupParser();
@@ -1449,6 +1731,9 @@ rcxml_init(void)
 	rc.adaptive_sync = LAB_ADAPTIVE_SYNC_DISABLED;
 	rc.allow_tearing = false;
 	rc.reuse_output_mode = false;
+	rc.latency_probe = false;
+	rc.hidden_frame_rate = 0;
+	rc.inactive_frame_rate = 0;
 	rc.xwayland_persistence = false;
 
 	init_font_defaults(&rc.font_activewindow);
@@ -1460,6 +1745,7 @@ rcxml_init(void)
 	rc.focus_follow_mouse = false;
 	rc.focus_follow_mouse_requires_movement = true;
 	rc.raise_on_focus = false;
+	rc.defer_map_focus = false;
 
 	rc.doubleclick_time = 500;
 
@@ -1475,6 +1761,7 @@ rcxml_init(void)
 	rc.repeat_delay = 600;
 	rc.kb_numlock_enable = true;
 	rc.kb_layout_per_window = false;
+	rc.modifier_broadcast = LAB_MODIFIER_BROADCAST_ALL;
 	rc.screen_edge_strength = 20;
 	rc.window_edge_strength = 20;
 	rc.unsnap_threshold = 20;
@@ -1696,6 +1983,9 @@ post_processing(void)
 	 */
 	deduplicate_key_bindings();
 	deduplicate_mouse_bindings();
+	keybind_index_rebuild();
+	mousebind_index_rebuild();
+	window_rules_update();
 
 	if (!rc.font_activewindow.name) {
 		rc.font_activewindow.name = xstrdup("sans");
@@ -1759,10 +2049,10 @@ static void
 rule_destroy(struct window_rule *rule)
 {
 	wl_list_remove(&rule->link);
-	zfree(rule->identifier);
-	zfree(rule->title);
-	zfree(rule->sandbox_engine);
-	zfree(rule->sandbox_app_id);
+	match_pattern_destroy(rule->identifier);
+	match_pattern_destroy(rule->title);
+	match_pattern_destroy(rule->sandbox_engine);
+	match_pattern_destroy(rule->sandbox_app_id);
 	action_list_free(&rule->actions);
 	zfree(rule);
 }
@@ -1892,19 +2182,17 @@ rcxml_read(const char *filename)
 
 		wlr_log(WLR_INFO, "read config file %s", path->string);
 
-		struct buf b = BUF_INIT;
-		char *line = NULL;
-		size_t len = 0;
-		while (getline(&line, &len, stream) != -1) {
-			char *p = strrchr(line, '\n');
-			if (p) {
-				*p = '\0';
-			}
-			buf_add(&b, line);
-		}
-		zfree(line);
+		struct buf b = grab_stream(stream);
 		fclose(stream);
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
 		rcxml_parse_xml(&b);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		/* Used by t/bench/parse-bench.sh */
+		wlr_log(WLR_DEBUG, "parsed config file in %ld us",
+			(long)(end.tv_sec - start.tv_sec) * 1000000
+			+ (end.tv_nsec - start.tv_nsec) / 1000);
 		buf_reset(&b);
 		if (!should_merge_config) {
 			break;
@@ -1944,6 +2232,9 @@ rcxml_finish(void)
 		zfree(area);
 	}
 
+	keybind_index_finish();
+	mousebind_index_finish();
+	node_index_finish();
 	struct keybind *k, *k_tmp;
 	wl_list_for_each_safe(k, k_tmp, &rc.keybinds, link) {
 		wl_list_remove(&k->link);
@@ -1,7 +1,14 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
 #include <wlr/types/wlr_layer_shell_v1.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/util/log.h>
+#include "buffer.h"
 #include "common/graphic-helpers.h"
+#include "common/macros.h"
+#include "common/scaled-scene-buffer.h"
 #include "common/scene-helpers.h"
 #include "debug.h"
 #include "input/ime.h"
@@ -263,3 +270,337 @@ debug_dump_scene(struct server *server)
 	 */
 	last_view = NULL;
 }
+
+enum mem_category {
+	MEM_OTHER = 0,
+	MEM_CLIENT,
+	MEM_SSD,
+	MEM_MENU,
+	MEM_OSD,
+
+	MEM_CATEGORY_COUNT
+};
+
+static const char * const category_names[] = {
+	[MEM_OTHER] = "other",
+	[MEM_CLIENT] = "client",
+	[MEM_SSD] = "ssd",
+	[MEM_MENU] = "menu",
+	[MEM_OSD] = "osd",
+};
+
+struct mem_usage {
+	size_t nodes[WLR_SCENE_NODE_BUFFER + 1];
+	size_t buffers;        /* lab_data_buffers referenced by buffer nodes */
+	size_t bytes;          /* pixel data of those lab_data_buffers */
+	size_t client_buffers; /* other (client) buffers */
+};
+
+struct view_mem_usage {
+	struct view *view;
+	struct mem_usage usage;
+};
+
+struct mem_walk {
+	struct server *server;
+	struct mem_usage categories[MEM_CATEGORY_COUNT];
+	struct wl_array views;  /* struct view_mem_usage */
+	struct wl_array seen;   /* struct wlr_buffer * */
+	size_t unique_buffers;
+	size_t unique_bytes;
+};
+
+static const char * const node_type_names[] = {
+	[WLR_SCENE_NODE_TREE] = "tree",
+	[WLR_SCENE_NODE_RECT] = "rect",
+	[WLR_SCENE_NODE_BUFFER] = "buffer",
+};
+
+static struct view *
+view_from_root_node(struct wlr_scene_node *node)
+{
+	struct node_descriptor *desc = node->data;
+	if (node->type != WLR_SCENE_NODE_TREE || !desc
+			|| desc->type != LAB_NODE_DESC_VIEW) {
+		return NULL;
+	}
+	struct view *view = desc->data;
+	return node == &view->scene_tree->node ? view : NULL;
+}
+
+static enum mem_category
+get_mem_category(struct server *server, struct view *view,
+		struct wlr_scene_node *node, enum mem_category parent)
+{
+	if (node == &server->menu_tree->node) {
+		return MEM_MENU;
+	}
+	if (node == &server->xdg_popup_tree->node) {
+		return MEM_CLIENT;
+	}
+#if HAVE_XWAYLAND
+	if (node == &server->unmanaged_tree->node) {
+		return MEM_CLIENT;
+	}
+#endif
+	if (view && ssd_debug_is_root_node(view->ssd, node)) {
+		return MEM_SSD;
+	}
+	if (view && node == view->scene_node) {
+		return MEM_CLIENT;
+	}
+	if (node->parent == &server->scene->tree) {
+		struct output *output;
+		wl_list_for_each(output, &server->outputs, link) {
+			if (node == &output->osd_tree->node) {
+				return MEM_OSD;
+			}
+			if (node == &output->layer_popup_tree->node
+					|| node == &output->session_lock_tree->node) {
+				return MEM_CLIENT;
+			}
+			for (size_t i = 0; i < ARRAY_SIZE(output->layer_tree); i++) {
+				if (node == &output->layer_tree[i]->node) {
+					return MEM_CLIENT;
+				}
+			}
+		}
+	}
+	return parent;
+}
+
+static bool
+mark_seen(struct mem_walk *walk, struct wlr_buffer *buffer)
+{
+	struct wlr_buffer **seen;
+	wl_array_for_each(seen, &walk->seen) {
+		if (*seen == buffer) {
+			return false;
+		}
+	}
+	seen = wl_array_add(&walk->seen, sizeof(*seen));
+	*seen = buffer;
+	return true;
+}
+
+static void
+add_usage(struct mem_usage *usage, struct wlr_scene_node *node,
+		struct wlr_buffer *client_buffer, size_t bytes)
+{
+	usage->nodes[node->type]++;
+	if (client_buffer) {
+		usage->client_buffers++;
+	} else if (bytes) {
+		usage->buffers++;
+		usage->bytes += bytes;
+	}
+}
+
+static void
+account_node(struct mem_walk *walk, struct wlr_scene_node *node,
+		enum mem_category category, struct mem_usage *view_usage)
+{
+	struct wlr_buffer *wlr_buffer = NULL;
+	struct lab_data_buffer *buffer = NULL;
+	if (node->type == WLR_SCENE_NODE_BUFFER) {
+		wlr_buffer = wlr_scene_buffer_from_node(node)->buffer;
+		buffer = buffer_try_from_wlr_buffer(wlr_buffer);
+	}
+
+	size_t bytes = 0;
+	if (buffer) {
+		bytes = buffer->stride * buffer->base.height;
+		/* Theme buffers are shared between views, count them once */
+		if (mark_seen(walk, wlr_buffer)) {
+			walk->unique_buffers++;
+			walk->unique_bytes += bytes;
+		}
+	}
+	struct wlr_buffer *client_buffer = buffer ? NULL : wlr_buffer;
+
+	add_usage(&walk->categories[category], node, client_buffer, bytes);
+	if (view_usage) {
+		add_usage(view_usage, node, client_buffer, bytes);
+	}
+}
+
+static void
+walk_mem(struct mem_walk *walk, struct wlr_scene_node *node,
+		struct view *view, struct mem_usage *view_usage,
+		enum mem_category category)
+{
+	struct view_mem_usage entry = { 0 };
+	struct view *root_view = view_from_root_node(node);
+	if (root_view) {
+		view = root_view;
+		entry.view = view;
+		view_usage = &entry.usage;
+	}
+
+	category = get_mem_category(walk->server, view, node, category);
+	account_node(walk, node, category, view_usage);
+
+	if (node->type == WLR_SCENE_NODE_TREE) {
+		struct wlr_scene_node *child;
+		struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
+		wl_list_for_each(child, &tree->children, link) {
+			walk_mem(walk, child, view, view_usage, category);
+		}
+	}
+
+	if (root_view) {
+		struct view_mem_usage *stored =
+			wl_array_add(&walk->views, sizeof(*stored));
+		*stored = entry;
+	}
+}
+
+static size_t
+nr_nodes(const struct mem_usage *usage)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < ARRAY_SIZE(usage->nodes); i++) {
+		count += usage->nodes[i];
+	}
+	return count;
+}
+
+static void
+print_json_string(FILE *stream, const char *str)
+{
+	fputc('"', stream);
+	for (const char *p = str ? str : ""; *p; p++) {
+		if (*p == '"' || *p == '\\') {
+			fprintf(stream, "\\%c", *p);
+		} else if ((unsigned char)*p < 0x20) {
+			fprintf(stream, "\\u%04x", *p);
+		} else {
+			fputc(*p, stream);
+		}
+	}
+	fputc('"', stream);
+}
+
+static void
+print_usage_json(FILE *stream, const struct mem_usage *usage)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(usage->nodes); i++) {
+		fprintf(stream, "\"%ss\": %zu, ", node_type_names[i],
+			usage->nodes[i]);
+	}
+	fprintf(stream, "\"lab_buffers\": %zu, \"lab_bytes\": %zu, "
+		"\"client_buffers\": %zu", usage->buffers, usage->bytes,
+		usage->client_buffers);
+}
+
+static void
+print_mem_json(FILE *stream, struct mem_walk *walk, size_t live_buffers,
+		size_t live_bytes, const struct scaled_scene_buffer_stats *scaled)
+{
+	fprintf(stream, "{\n  \"categories\": {\n");
+	for (size_t i = 0; i < MEM_CATEGORY_COUNT; i++) {
+		fprintf(stream, "    \"%s\": { ", category_names[i]);
+		print_usage_json(stream, &walk->categories[i]);
+		fprintf(stream, " }%s\n", i + 1 < MEM_CATEGORY_COUNT ? "," : "");
+	}
+	fprintf(stream, "  },\n  \"views\": [");
+	struct view_mem_usage *entry;
+	bool first = true;
+	wl_array_for_each(entry, &walk->views) {
+		fprintf(stream, "%s\n    { \"app_id\": ", first ? "" : ",");
+		print_json_string(stream,
+			view_get_string_prop(entry->view, "app_id"));
+		fprintf(stream, ", \"title\": ");
+		print_json_string(stream,
+			view_get_string_prop(entry->view, "title"));
+		fprintf(stream, ", ");
+		print_usage_json(stream, &entry->usage);
+		fprintf(stream, " }");
+		first = false;
+	}
+	fprintf(stream, "\n  ],\n");
+	fprintf(stream, "  \"lab_data_buffers\": { \"scene\": %zu, "
+		"\"scene_bytes\": %zu, \"live\": %zu, \"live_bytes\": %zu },\n",
+		walk->unique_buffers, walk->unique_bytes, live_buffers,
+		live_bytes);
+	fprintf(stream, "  \"scaled_scene_buffers\": { \"instances\": %zu, "
+		"\"cache_entries\": %zu, \"hits\": %zu, \"misses\": %zu }\n}\n",
+		scaled->instances, scaled->cache_entries, scaled->hits,
+		scaled->misses);
+}
+
+static void
+print_mem_text(FILE *stream, struct mem_walk *walk, size_t live_buffers,
+		size_t live_bytes, const struct scaled_scene_buffer_stats *scaled)
+{
+	fprintf(stream, "%-24s %7s %7s %7s %11s %11s %14s\n", "category",
+		"trees", "rects", "buffers", "lab-buffers", "lab-bytes",
+		"client-buffers");
+	for (size_t i = 0; i < MEM_CATEGORY_COUNT; i++) {
+		const struct mem_usage *usage = &walk->categories[i];
+		fprintf(stream, "%-24s %7zu %7zu %7zu %11zu %11zu %14zu\n",
+			category_names[i],
+			usage->nodes[WLR_SCENE_NODE_TREE],
+			usage->nodes[WLR_SCENE_NODE_RECT],
+			usage->nodes[WLR_SCENE_NODE_BUFFER],
+			usage->buffers, usage->bytes, usage->client_buffers);
+	}
+
+	fprintf(stream, "\n%-24s %7s %11s %11s\n", "view (app_id)", "nodes",
+		"lab-buffers", "lab-bytes");
+	struct view_mem_usage *entry;
+	wl_array_for_each(entry, &walk->views) {
+		const char *app_id = view_get_string_prop(entry->view, "app_id");
+		fprintf(stream, "%-24.24s %7zu %11zu %11zu\n",
+			app_id ? app_id : "-", nr_nodes(&entry->usage),
+			entry->usage.buffers, entry->usage.bytes);
+	}
+
+	fprintf(stream, "\nlab_data_buffers: %zu in scene (%zu bytes), "
+		"%zu alive (%zu bytes)\n", walk->unique_buffers,
+		walk->unique_bytes, live_buffers, live_bytes);
+	size_t lookups = scaled->hits + scaled->misses;
+	fprintf(stream, "scaled_scene_buffers: %zu instances, "
+		"%zu cached buffers, %zu hits, %zu misses (%.1f%% hit rate)\n",
+		scaled->instances, scaled->cache_entries, scaled->hits,
+		scaled->misses,
+		lookups ? 100.0 * scaled->hits / lookups : 0.0);
+}
+
+void
+debug_dump_memory(struct server *server, const char *filename, bool json)
+{
+	FILE *stream = stdout;
+	if (filename) {
+		stream = fopen(filename, "w");
+		if (!stream) {
+			wlr_log(WLR_ERROR, "cannot write memory stats to '%s': %s",
+				filename, strerror(errno));
+			return;
+		}
+	}
+
+	struct mem_walk walk = { .server = server };
+	wl_array_init(&walk.views);
+	wl_array_init(&walk.seen);
+	walk_mem(&walk, &server->scene->tree.node, NULL, NULL, MEM_OTHER);
+
+	size_t live_buffers, live_bytes;
+	buffer_get_stats(&live_buffers, &live_bytes);
+	struct scaled_scene_buffer_stats scaled;
+	scaled_scene_buffer_get_stats(&scaled);
+
+	if (json) {
+		print_mem_json(stream, &walk, live_buffers, live_bytes, &scaled);
+	} else {
+		print_mem_text(stream, &walk, live_buffers, live_bytes, &scaled);
+	}
+
+	wl_array_release(&walk.views);
+	wl_array_release(&walk.seen);
+	if (stream == stdout) {
+		fflush(stream);
+	} else {
+		fclose(stream);
+	}
+}
@@ -9,6 +9,7 @@
 #include "node.h"
 #include "osd.h"
 #include "ssd.h"
+#include "trace.h"
 #include "view.h"
 #include "window-rules.h"
 #include "workspaces.h"
@@ -39,10 +40,45 @@ desktop_arrange_all_views(struct server *server)
 	}
 }
 
+/*
+ * Only the usable area of a view's own output is taken into account when
+ * adjusting it, apart from views which have lost their output or which may
+ * be restored to a position on @output.
+ */
+static bool
+view_depends_on_output(struct view *view, struct output *output)
+{
+	if (view->output == output || !output_is_usable(view->output)
+			|| view->tiled_region_evacuate) {
+		return true;
+	}
+	struct wlr_box output_box, intersection;
+	wlr_output_layout_get_box(view->server->output_layout,
+		output->wlr_output, &output_box);
+	return wlr_box_intersection(&intersection,
+		&view->last_layout_geometry, &output_box);
+}
+
+void
+desktop_arrange_views_on_output(struct output *output)
+{
+	struct view *view;
+	wl_list_for_each(view, &output->server->views, link) {
+		if (!wlr_box_empty(&view->pending)
+				&& view_depends_on_output(view, output)) {
+			view_adjust_for_layout_change(view);
+		}
+	}
+}
+
 void
 desktop_focus_view(struct view *view, bool raise)
 {
 	assert(view);
+
+	/* Supersedes any focus change queued by view_impl_map() */
+	view->server->map_batch.focus = NULL;
+
 	/*
 	 * Guard against views with no mapped surfaces when handling
 	 * 'request_activate' and 'request_minimize'.
@@ -270,6 +306,7 @@ get_surface_from_layer_node(struct wlr_scene_node *node)
 struct cursor_context
 get_cursor_context(struct server *server)
 {
+	TRACE_SPAN("get_cursor_context");
 	struct cursor_context ret = {.type = LAB_SSD_NONE};
 	struct wlr_cursor *cursor = server->seat.cursor;
 
@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wlr/types/wlr_input_device.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/util/log.h>
+#include "common/macros.h"
+#include "common/mem.h"
+#include "config/rcxml.h"
+#include "frame-stats.h"
+#include "labwc.h"
+
+/* Roughly 8 seconds worth of frames at 60 Hz */
+#define FRAME_STATS_WINDOW 512
+
+struct sample_window {
+	uint32_t usec[FRAME_STATS_WINDOW];
+	size_t next;
+	size_t len;
+};
+
+/* Input-to-photon latency of a single input device */
+struct latency_device {
+	char *name;
+	struct sample_window window;
+	struct wl_list link;
+};
+
+/* An input event waiting to be presented, unused if device is NULL */
+struct input_sample {
+	struct timespec time;
+	struct latency_device *device;
+};
+
+struct frame_stats {
+	struct sample_window windows[LAB_FRAME_STAT_COUNT];
+	unsigned long counters[LAB_FRAME_COUNTER_COUNT];
+	struct timespec frame_start;
+	bool frame_pending;
+
+	/* Oldest input which arrived since the last commit */
+	struct input_sample pending_input;
+	/* Input attached to the commit with sequence number inflight_seq */
+	struct input_sample inflight_input;
+	uint32_t inflight_seq;
+};
+
+/* struct latency_device.link, shared by all outputs */
+static struct wl_list latency_devices = {
+	.prev = &latency_devices,
+	.next = &latency_devices,
+};
+
+static const char * const stat_names[] = {
+	[LAB_FRAME_STAT_FRAME_TO_COMMIT] = "frame-to-commit",
+	[LAB_FRAME_STAT_BUILD_STATE] = "build-state",
+	[LAB_FRAME_STAT_TEARING_TEST] = "tearing-test",
+	[LAB_FRAME_STAT_MAGNIFY] = "magnify",
+	[LAB_FRAME_STAT_COMMIT] = "commit",
+	[LAB_FRAME_STAT_INPUT_TO_PHOTON] = "input-to-photon",
+};
+
+static_assert(ARRAY_SIZE(stat_names) == LAB_FRAME_STAT_COUNT,
+	"stat_names out of sync with enum frame_stat");
+
+static uint32_t
+elapsed_usec(const struct timespec *start, const struct timespec *end)
+{
+	int64_t usec = (int64_t)(end->tv_sec - start->tv_sec) * 1000000
+		+ (end->tv_nsec - start->tv_nsec) / 1000;
+	if (usec < 0) {
+		return 0;
+	}
+	return usec > UINT32_MAX ? UINT32_MAX : (uint32_t)usec;
+}
+
+static void
+add_sample(struct sample_window *window, uint32_t usec)
+{
+	window->usec[window->next] = usec;
+	window->next = (window->next + 1) % FRAME_STATS_WINDOW;
+	if (window->len < FRAME_STATS_WINDOW) {
+		window->len++;
+	}
+}
+
+struct frame_stats *
+frame_stats_create(void)
+{
+	struct frame_stats *stats = znew(*stats);
+	return stats;
+}
+
+void
+frame_stats_destroy(struct frame_stats *stats)
+{
+	free(stats);
+}
+
+void
+frame_stats_frame_begin(struct frame_stats *stats)
+{
+	assert(stats);
+	clock_gettime(CLOCK_MONOTONIC, &stats->frame_start);
+	stats->frame_pending = true;
+	stats->counters[LAB_FRAME_COUNTER_FRAMES]++;
+}
+
+void
+frame_stats_frame_committed(struct frame_stats *stats)
+{
+	assert(stats);
+	if (!stats->frame_pending) {
+		return;
+	}
+	stats->frame_pending = false;
+	frame_stats_lap(stats, LAB_FRAME_STAT_FRAME_TO_COMMIT,
+		&stats->frame_start);
+}
+
+void
+frame_stats_lap(struct frame_stats *stats, enum frame_stat stat,
+		struct timespec *since)
+{
+	assert(stats);
+	assert(stat < LAB_FRAME_STAT_COUNT);
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	add_sample(&stats->windows[stat], elapsed_usec(since, &now));
+	*since = now;
+}
+
+void
+frame_stats_inc(struct frame_stats *stats, enum frame_counter counter)
+{
+	assert(stats);
+	assert(counter < LAB_FRAME_COUNTER_COUNT);
+	stats->counters[counter]++;
+	if (counter == LAB_FRAME_COUNTER_SKIPPED
+			|| counter == LAB_FRAME_COUNTER_FAILED) {
+		/* Skipped and failed frames never reach the commit */
+		stats->frame_pending = false;
+	}
+}
+
+static struct latency_device *
+get_latency_device(struct wlr_input_device *wlr_device)
+{
+	const char *name = wlr_device->name ? wlr_device->name : "unknown";
+	struct latency_device *device;
+	wl_list_for_each(device, &latency_devices, link) {
+		if (!strcmp(device->name, name)) {
+			return device;
+		}
+	}
+	device = znew(*device);
+	device->name = xstrdup(name);
+	wl_list_insert(latency_devices.prev, &device->link);
+	return device;
+}
+
+void
+frame_stats_input(struct output *output, struct wlr_input_device *device)
+{
+	if (!rc.latency_probe || !output || !output->frame_stats) {
+		return;
+	}
+	struct frame_stats *stats = output->frame_stats;
+	if (stats->pending_input.device) {
+		/* Only the oldest input per frame is of interest */
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &stats->pending_input.time);
+	stats->pending_input.device = get_latency_device(device);
+}
+
+void
+frame_stats_commit_begin(struct frame_stats *stats, uint32_t commit_seq)
+{
+	assert(stats);
+	if (!stats->pending_input.device) {
+		return;
+	}
+	/*
+	 * Some backends (e.g. headless) emit the present event from
+	 * within the commit, so this has to happen before committing.
+	 */
+	stats->inflight_input = stats->pending_input;
+	stats->inflight_seq = commit_seq;
+	stats->pending_input.device = NULL;
+}
+
+void
+frame_stats_commit_failed(struct frame_stats *stats)
+{
+	assert(stats);
+	if (stats->inflight_input.device && !stats->pending_input.device) {
+		stats->pending_input = stats->inflight_input;
+	}
+	stats->inflight_input.device = NULL;
+}
+
+void
+frame_stats_presented(struct frame_stats *stats,
+		struct wlr_output_event_present *event)
+{
+	assert(stats);
+	struct input_sample *input = &stats->inflight_input;
+	if (!input->device || event->commit_seq != stats->inflight_seq) {
+		return;
+	}
+	/*
+	 * Presentation timestamps use CLOCK_MONOTONIC as well. Some
+	 * backends do not provide one, skip the sample in that case.
+	 */
+	if (event->presented && event->when) {
+		uint32_t usec = elapsed_usec(&input->time, event->when);
+		add_sample(&stats->windows[LAB_FRAME_STAT_INPUT_TO_PHOTON], usec);
+		add_sample(&input->device->window, usec);
+	}
+	input->device = NULL;
+}
+
+void
+frame_stats_finish(void)
+{
+	struct latency_device *device, *tmp;
+	wl_list_for_each_safe(device, tmp, &latency_devices, link) {
+		wl_list_remove(&device->link);
+		free(device->name);
+		free(device);
+	}
+}
+
+static int
+compare_usec(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+static uint32_t
+percentile(const uint32_t *sorted, size_t len, unsigned int pct)
+{
+	return sorted[(len - 1) * pct / 100];
+}
+
+static void
+dump_window(FILE *stream, const char *name, struct sample_window *window)
+{
+	if (!window->len) {
+		fprintf(stream, "  %-16s %8d\n", name, 0);
+		return;
+	}
+	uint32_t sorted[FRAME_STATS_WINDOW];
+	memcpy(sorted, window->usec, window->len * sizeof(*sorted));
+	qsort(sorted, window->len, sizeof(*sorted), compare_usec);
+	fprintf(stream, "  %-16s %8zu %8u %8u %8u %8u\n",
+		name, window->len,
+		(unsigned int)percentile(sorted, window->len, 50),
+		(unsigned int)percentile(sorted, window->len, 95),
+		(unsigned int)percentile(sorted, window->len, 99),
+		(unsigned int)sorted[window->len - 1]);
+}
+
+static void
+dump_header(FILE *stream)
+{
+	fprintf(stream, "  %-16s %8s %8s %8s %8s %8s\n", "usec",
+		"samples", "p50", "p95", "p99", "max");
+}
+
+static void
+dump_output(FILE *stream, struct output *output)
+{
+	struct frame_stats *stats = output->frame_stats;
+	fprintf(stream, "%s: frames %lu, skipped %lu, failed %lu, "
+		"scanout %lu, composited %lu\n",
+		output->wlr_output->name,
+		stats->counters[LAB_FRAME_COUNTER_FRAMES],
+		stats->counters[LAB_FRAME_COUNTER_SKIPPED],
+		stats->counters[LAB_FRAME_COUNTER_FAILED],
+		stats->counters[LAB_FRAME_COUNTER_SCANOUT],
+		stats->counters[LAB_FRAME_COUNTER_COMPOSITED]);
+	dump_header(stream);
+	for (size_t i = 0; i < LAB_FRAME_STAT_COUNT; i++) {
+		dump_window(stream, stat_names[i], &stats->windows[i]);
+	}
+}
+
+static void
+dump_devices(FILE *stream, bool reset)
+{
+	struct latency_device *device;
+	wl_list_for_each(device, &latency_devices, link) {
+		fprintf(stream, "%s:\n", device->name);
+		dump_header(stream);
+		dump_window(stream, stat_names[LAB_FRAME_STAT_INPUT_TO_PHOTON],
+			&device->window);
+		if (reset) {
+			memset(&device->window, 0, sizeof(device->window));
+		}
+	}
+}
+
+void
+frame_stats_dump(struct server *server, const char *filename, bool reset)
+{
+	FILE *stream = stdout;
+	if (filename) {
+		stream = fopen(filename, "w");
+		if (!stream) {
+			wlr_log(WLR_ERROR, "cannot write frame stats to '%s': %s",
+				filename, strerror(errno));
+			return;
+		}
+	}
+
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output->frame_stats) {
+			continue;
+		}
+		dump_output(stream, output);
+		if (reset) {
+			memset(output->frame_stats, 0, sizeof(*output->frame_stats));
+		}
+	}
+	if (rc.latency_probe) {
+		dump_devices(stream, reset);
+	}
+
+	if (stream == stdout) {
+		fflush(stream);
+	} else {
+		fclose(stream);
+	}
+}
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_scene.h>
+#include "common/macros.h"
+#include "config/rcxml.h"
+#include "frame-throttle.h"
+#include "labwc.h"
+#include "node.h"
+#include "view.h"
+
+struct frame_done_ctx {
+	struct output *output;
+	struct timespec *now;
+	int64_t now_usec;
+	int64_t interval_usec;
+	/* Earliest time a held back frame callback is due, 0 if none */
+	int64_t next_due_usec;
+};
+
+static int64_t
+timespec_to_usec(const struct timespec *t)
+{
+	return (int64_t)t->tv_sec * 1000000 + t->tv_nsec / 1000;
+}
+
+static struct view *
+view_from_node(struct wlr_scene_node *node)
+{
+	while (node) {
+		struct node_descriptor *desc = node->data;
+		if (desc && (desc->type == LAB_NODE_DESC_VIEW
+				|| desc->type == LAB_NODE_DESC_XDG_POPUP)) {
+			return desc->data;
+		}
+		node = node->parent ? &node->parent->node : NULL;
+	}
+	return NULL;
+}
+
+static bool
+is_throttled(struct view *view, struct frame_done_ctx *ctx)
+{
+	if (!view || view == view->server->active_view || view->fullscreen) {
+		return false;
+	}
+	if (view->frame_done_usec == ctx->now_usec) {
+		/* Another surface of the view got its callback this frame */
+		return false;
+	}
+
+	/*
+	 * Frame events arrive in multiples of the refresh interval, allow
+	 * for some jitter so that e.g. 30 fps on a 60 Hz output means every
+	 * other frame rather than every third one.
+	 */
+	int64_t due = view->frame_done_usec + ctx->interval_usec
+		- ctx->interval_usec / 8;
+	if (ctx->now_usec < due) {
+		if (!ctx->next_due_usec || due < ctx->next_due_usec) {
+			ctx->next_due_usec = due;
+		}
+		return true;
+	}
+	view->frame_done_usec = ctx->now_usec;
+	return false;
+}
+
+static void
+send_buffer_frame_done(struct wlr_scene_buffer *buffer, int sx, int sy,
+		void *data)
+{
+	struct frame_done_ctx *ctx = data;
+
+	/* Same condition as wlr_scene_output_send_frame_done() */
+	if (buffer->primary_output != ctx->output->scene_output) {
+		return;
+	}
+	if (!ctx->interval_usec) {
+		wlr_scene_buffer_send_frame_done(buffer, ctx->now);
+		return;
+	}
+
+	struct wlr_scene_surface *scene_surface =
+		wlr_scene_surface_try_from_buffer(buffer);
+	if (scene_surface && wl_list_empty(
+			&scene_surface->surface->current.frame_callback_list)) {
+		/* The client is idle, nothing to hold back */
+		return;
+	}
+	if (is_throttled(view_from_node(&buffer->node), ctx)) {
+		return;
+	}
+	wlr_scene_buffer_send_frame_done(buffer, ctx->now);
+}
+
+static int
+handle_output_timer(void *data)
+{
+	struct output *output = data;
+	if (output_is_usable(output)) {
+		wlr_output_schedule_frame(output->wlr_output);
+	}
+	return 0;
+}
+
+void
+frame_throttle_send_frame_done(struct output *output,
+		struct timespec *now)
+{
+	struct frame_done_ctx ctx = {
+		.output = output,
+		.now = now,
+		.now_usec = timespec_to_usec(now),
+	};
+	if (rc.inactive_frame_rate > 0) {
+		ctx.interval_usec = 1000000 / rc.inactive_frame_rate;
+	}
+
+	wlr_scene_output_for_each_buffer(output->scene_output,
+		send_buffer_frame_done, &ctx);
+
+	if (!ctx.next_due_usec) {
+		/* Nothing held back, drop a frame scheduled earlier */
+		if (output->frame_throttle_timer) {
+			wl_event_source_timer_update(
+				output->frame_throttle_timer, 0);
+		}
+		return;
+	}
+
+	/*
+	 * Frame events are only emitted on damage, so make sure there is
+	 * one when the held back callbacks are due. Otherwise a client
+	 * waiting for its callback would never draw again.
+	 */
+	if (!output->frame_throttle_timer) {
+		output->frame_throttle_timer = wl_event_loop_add_timer(
+			output->server->wl_event_loop, handle_output_timer,
+			output);
+	}
+	int delay_msec = (ctx.next_due_usec - ctx.now_usec + 999) / 1000;
+	wl_event_source_timer_update(output->frame_throttle_timer,
+		MAX(delay_msec, 1));
+}
+
+static void
+send_surface_frame_done(struct wlr_surface *surface, int sx, int sy,
+		void *data)
+{
+	wlr_surface_send_frame_done(surface, data);
+}
+
+static bool
+view_is_hidden(struct view *view)
+{
+	if (view->minimized) {
+		/* Minimized views are unmapped by labwc, not by the client */
+		return view->surface;
+	}
+	if (!view->mapped || !view->surface || !view->scene_node) {
+		return false;
+	}
+	/*
+	 * Shaded views and views on other workspaces both have a
+	 * disabled node somewhere up the tree.
+	 */
+	int x, y;
+	return !wlr_scene_node_coords(view->scene_node, &x, &y);
+}
+
+static void
+arm_hidden_timer(struct server *server)
+{
+	wl_event_source_timer_update(server->hidden_frame_timer,
+		MAX(1000 / rc.hidden_frame_rate, 1));
+}
+
+static int
+handle_hidden_timer(void *data)
+{
+	struct server *server = data;
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view_is_hidden(view)) {
+			wlr_surface_for_each_surface(view->surface,
+				send_surface_frame_done, &now);
+		}
+	}
+
+	if (rc.hidden_frame_rate > 0) {
+		arm_hidden_timer(server);
+	}
+	return 0;
+}
+
+void
+frame_throttle_reconfigure(struct server *server)
+{
+	if (rc.hidden_frame_rate <= 0) {
+		if (server->hidden_frame_timer) {
+			wl_event_source_remove(server->hidden_frame_timer);
+			server->hidden_frame_timer = NULL;
+		}
+		return;
+	}
+
+	if (!server->hidden_frame_timer) {
+		server->hidden_frame_timer = wl_event_loop_add_timer(
+			server->wl_event_loop, handle_hidden_timer, server);
+	}
+	arm_hidden_timer(server);
+}
+
+void
+frame_throttle_output_finish(struct output *output)
+{
+	if (output->frame_throttle_timer) {
+		wl_event_source_remove(output->frame_throttle_timer);
+		output->frame_throttle_timer = NULL;
+	}
+}
+
+void
+frame_throttle_finish(struct server *server)
+{
+	if (server->hidden_frame_timer) {
+		wl_event_source_remove(server->hidden_frame_timer);
+		server->hidden_frame_timer = NULL;
+	}
+}
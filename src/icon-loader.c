@@ -18,6 +18,7 @@
 #endif
 
 #include "labwc.h"
+#include "trace.h"
 
 struct icon_loader {
 	struct sfdo_desktop_ctx *desktop_ctx;
@@ -243,6 +244,7 @@ struct lab_data_buffer *
 icon_loader_lookup(struct server *server, const char *app_id, int size,
 		float scale)
 {
+	TRACE_SPAN("icon_loader_lookup");
 	struct icon_loader *loader = server->icon_loader;
 	if (!loader) {
 		return NULL;
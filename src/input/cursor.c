@@ -15,6 +15,7 @@
 #include "config/mousebind.h"
 #include "config/tablet-tool.h"
 #include "dnd.h"
+#include "frame-stats.h"
 #include "idle.h"
 #include "input/gestures.h"
 #include "input/touch.h"
@@ -27,6 +28,7 @@
 #include "resistance.h"
 #include "resize-outlines.h"
 #include "ssd.h"
+#include "trace.h"
 #include "view.h"
 #include "xwayland.h"
 
@@ -233,6 +235,36 @@ request_set_primary_selection_notify(struct wl_listener *listener, void *data)
 static void
 process_cursor_move(struct server *server, uint32_t time)
 {
+	/*
+	 * High polling rate pointers generate many motion events per
+	 * frame. Just remember that the grabbed view has to follow the
+	 * cursor and move it once per output frame instead.
+	 */
+	if (server->move_pending) {
+		return;
+	}
+	struct output *output = output_nearest_to_cursor(server);
+	if (!output_is_usable(output)) {
+		/* No frame will come, move right away */
+		server->move_pending = true;
+		cursor_flush_move(server);
+		return;
+	}
+	server->move_pending = true;
+	wlr_output_schedule_frame(output->wlr_output);
+}
+
+void
+cursor_flush_move(struct server *server)
+{
+	if (!server->move_pending) {
+		return;
+	}
+	server->move_pending = false;
+	if (server->input_mode != LAB_INPUT_STATE_MOVE) {
+		return;
+	}
+
 	struct view *view = server->grabbed_view;
 
 	int x = server->grab_box.x + (server->seat.cursor->x - server->grab_x);
@@ -265,13 +297,17 @@ process_cursor_move(struct server *server, uint32_t time)
 	resistance_move_apply(view, &x, &y);
 
 	view_move(view, x, y);
+
+	/* At most one X11 configure per frame, see xwayland_view_configure() */
+	view_flush_configure(view);
+
 	overlay_update(&server->seat);
 }
 
-static void
-process_cursor_resize(struct server *server, uint32_t time)
+/* Rate-limit resize events respecting monitor refresh rate */
+static bool
+resize_rate_limited(struct server *server, uint32_t time)
 {
-	/* Rate-limit resize events respecting monitor refresh rate */
 	static uint32_t last_resize_time = 0;
 	static struct view *last_resize_view = NULL;
 
@@ -286,12 +322,30 @@ process_cursor_resize(struct server *server, uint32_t time)
 		}
 		/* Not caring overflow, but it won't be observable */
 		if (time - last_resize_time < 1000000 / (uint32_t)refresh) {
-			return;
+			return true;
 		}
 	}
 
 	last_resize_time = time;
 	last_resize_view = server->grabbed_view;
+	return false;
+}
+
+static void
+process_cursor_resize(struct server *server, uint32_t time)
+{
+	/*
+	 * xdg-shell clients acknowledge configure requests, so resizing
+	 * them is paced by the client: while a configure is outstanding the
+	 * latest geometry is stored and sent from
+	 * interactive_resize_configure_done(). Everything else (outlines,
+	 * XWayland views) is rate-limited to the output refresh rate.
+	 */
+	bool client_paced = rc.resize_draw_contents
+		&& server->grabbed_view->type == LAB_XDG_SHELL_VIEW;
+	if (!client_paced && resize_rate_limited(server, time)) {
+		return;
+	}
 
 	double dx = server->seat.cursor->x - server->grab_x;
 	double dy = server->seat.cursor->y - server->grab_y;
@@ -330,10 +384,14 @@ process_cursor_resize(struct server *server, uint32_t time)
 			server->grab_box.width - new_view_geo.width;
 	}
 
-	if (rc.resize_draw_contents) {
-		view_move_resize(view, new_view_geo);
-	} else {
+	if (!rc.resize_draw_contents) {
 		resize_outlines_update(view, new_view_geo);
+	} else if (client_paced && view->pending_configure_serial) {
+		server->resize_pending_geo = new_view_geo;
+		server->resize_pending = true;
+	} else {
+		server->resize_pending = false;
+		view_move_resize(view, new_view_geo);
 	}
 }
 
@@ -555,6 +613,7 @@ cursor_get_resize_edges(struct wlr_cursor *cursor, struct cursor_context *ctx)
 bool
 cursor_process_motion(struct server *server, uint32_t time, double *sx, double *sy)
 {
+	TRACE_SPAN("cursor_process_motion");
 	/* If the mode is non-passthrough, delegate to those functions. */
 	if (server->input_mode == LAB_INPUT_STATE_MOVE) {
 		process_cursor_move(server, time);
@@ -799,6 +858,10 @@ preprocess_cursor_motion(struct seat *seat, struct wlr_pointer *pointer,
 	 * without any input.
 	 */
 	wlr_cursor_move(seat->cursor, &pointer->base, dx, dy);
+	if (rc.latency_probe) {
+		frame_stats_input(output_nearest_to_cursor(seat->server),
+			&pointer->base);
+	}
 	double sx, sy;
 	bool notify = cursor_process_motion(seat->server, time_msec, &sx, &sy);
 	if (notify) {
@@ -868,15 +931,18 @@ handle_release_mousebinding(struct server *server,
 		return;
 	}
 
-	struct mousebind *mousebind;
-
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
 			&server->seat.keyboard_group->keyboard);
+	struct wl_array *mousebinds =
+		mousebind_index_lookup_button(modifiers, button);
+	if (!mousebinds) {
+		return;
+	}
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->button == button
-				&& modifiers == mousebind->modifiers) {
+	struct mousebind **entry;
+	wl_array_for_each(entry, mousebinds) {
+		struct mousebind *mousebind = *entry;
+		if (mousebind_in_context(mousebind, ctx->type)) {
 			switch (mousebind->mouse_event) {
 			case MOUSE_ACTION_RELEASE:
 				break;
@@ -935,17 +1001,21 @@ handle_press_mousebinding(struct server *server, struct cursor_context *ctx,
 		return false;
 	}
 
-	struct mousebind *mousebind;
 	bool double_click = is_double_click(rc.doubleclick_time, button, ctx);
 	bool consumed_by_frame_context = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
 			&server->seat.keyboard_group->keyboard);
+	struct wl_array *mousebinds =
+		mousebind_index_lookup_button(modifiers, button);
+	if (!mousebinds) {
+		return false;
+	}
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->button == button
-				&& modifiers == mousebind->modifiers) {
+	struct mousebind **entry;
+	wl_array_for_each(entry, mousebinds) {
+		struct mousebind *mousebind = *entry;
+		if (mousebind_in_context(mousebind, ctx->type)) {
 			switch (mousebind->mouse_event) {
 			case MOUSE_ACTION_DRAG: /* fallthrough */
 			case MOUSE_ACTION_CLICK:
@@ -1267,7 +1337,6 @@ static bool
 handle_cursor_axis(struct server *server, struct cursor_context *ctx,
 		struct wlr_pointer_axis_event *event)
 {
-	struct mousebind *mousebind;
 	bool handled = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
@@ -1296,11 +1365,16 @@ handle_cursor_axis(struct server *server, struct cursor_context *ctx,
 		return false;
 	}
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->direction == direction
-				&& modifiers == mousebind->modifiers
-				&& mousebind->mouse_event == MOUSE_ACTION_SCROLL) {
+	struct wl_array *mousebinds =
+		mousebind_index_lookup_scroll(modifiers, direction);
+	if (!mousebinds) {
+		return false;
+	}
+
+	struct mousebind **entry;
+	wl_array_for_each(entry, mousebinds) {
+		struct mousebind *mousebind = *entry;
+		if (mousebind_in_context(mousebind, ctx->type)) {
 			handled = true;
 			actions_run(ctx->view, server, &mousebind->actions, ctx);
 		}
@@ -2,10 +2,12 @@
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wlr/backend/multi.h>
 #include <wlr/backend/session.h>
 #include <wlr/interfaces/wlr_keyboard.h>
 #include "action.h"
+#include "frame-stats.h"
 #include "idle.h"
 #include "input/ime.h"
 #include "input/keyboard.h"
@@ -14,6 +16,7 @@
 #include "menu/menu.h"
 #include "osd.h"
 #include "regions.h"
+#include "trace.h"
 #include "view.h"
 #include "workspaces.h"
 
@@ -87,36 +90,88 @@ seat_client_from_keyboard_resource(struct wl_resource *resource)
 }
 
 static void
-broadcast_modifiers_to_unfocused_clients(struct wlr_seat *seat,
+send_modifiers(struct wlr_seat_client *client,
 		const struct wlr_keyboard_modifiers *modifiers)
 {
-	struct wlr_seat_client *client;
-	wl_list_for_each(client, &seat->clients, link) {
-		if (client == seat->keyboard_state.focused_client) {
-			/*
-			 * We've already notified the focused client by calling
-			 * wlr_seat_keyboard_notify_modifiers()
-			 */
+	uint32_t serial = wlr_seat_client_next_serial(client);
+	struct wl_resource *resource;
+	wl_resource_for_each(resource, &client->keyboards) {
+		if (!seat_client_from_keyboard_resource(resource)) {
 			continue;
 		}
-		uint32_t serial = wlr_seat_client_next_serial(client);
-		struct wl_resource *resource;
-		wl_resource_for_each(resource, &client->keyboards) {
-			if (!seat_client_from_keyboard_resource(resource)) {
-				continue;
-			}
-			if (!modifiers) {
-				wl_keyboard_send_modifiers(resource, serial, 0,
-					0, 0, 0);
-			} else {
-				wl_keyboard_send_modifiers(resource, serial,
-					modifiers->depressed, modifiers->latched,
-					modifiers->locked, modifiers->group);
-			}
+		wl_keyboard_send_modifiers(resource, serial,
+			modifiers->depressed, modifiers->latched,
+			modifiers->locked, modifiers->group);
+	}
+}
+
+static void
+broadcast_modifiers_to_unfocused_clients(void *data)
+{
+	struct seat *seat = data;
+	struct wlr_seat *wlr_seat = seat->seat;
+	const struct wlr_keyboard_modifiers *modifiers =
+		&seat->modifier_broadcast.pending;
+	seat->modifier_broadcast.idle = NULL;
+
+	/*
+	 * The focused client has already been notified by calling
+	 * wlr_seat_keyboard_notify_modifiers()
+	 */
+	struct wlr_seat_client *focused = wlr_seat->keyboard_state.focused_client;
+	struct wlr_seat_client *target = NULL;
+	if (rc.modifier_broadcast == LAB_MODIFIER_BROADCAST_POINTER) {
+		target = wlr_seat->pointer_state.focused_client;
+		if (!target || target == focused) {
+			return;
+		}
+	}
+
+	/* Skip if the same clients have already been sent this state */
+	if (seat->modifier_broadcast.sent_valid
+			&& seat->modifier_broadcast.sent_focused == focused
+			&& seat->modifier_broadcast.sent_target == target
+			&& !memcmp(&seat->modifier_broadcast.sent, modifiers,
+				sizeof(*modifiers))) {
+		return;
+	}
+	seat->modifier_broadcast.sent_valid = true;
+	seat->modifier_broadcast.sent = *modifiers;
+	seat->modifier_broadcast.sent_focused = focused;
+	seat->modifier_broadcast.sent_target = target;
+
+	if (target) {
+		send_modifiers(target, modifiers);
+		return;
+	}
+	struct wlr_seat_client *client;
+	wl_list_for_each(client, &wlr_seat->clients, link) {
+		if (client != focused) {
+			send_modifiers(client, modifiers);
 		}
 	}
 }
 
+/*
+ * Modifier changes often come in bursts (e.g. several keyboards in the
+ * keyboard group or press and release handled in one go), so the
+ * broadcast is done once the event loop is idle.
+ */
+static void
+schedule_modifier_broadcast(struct seat *seat,
+		const struct wlr_keyboard_modifiers *modifiers)
+{
+	if (rc.modifier_broadcast == LAB_MODIFIER_BROADCAST_NONE) {
+		return;
+	}
+	seat->modifier_broadcast.pending = *modifiers;
+	if (!seat->modifier_broadcast.idle) {
+		seat->modifier_broadcast.idle = wl_event_loop_add_idle(
+			seat->server->wl_event_loop,
+			broadcast_modifiers_to_unfocused_clients, seat);
+	}
+}
+
 static void
 keyboard_modifiers_notify(struct wl_listener *listener, void *data)
 {
@@ -168,12 +223,11 @@ keyboard_modifiers_notify(struct wl_listener *listener, void *data)
 		 * clients, whereas KWin and Weston pass modifiers to clients
 		 * with pointer-focus.
 		 *
-		 * This could be made configurable if there are unintended
-		 * consequences. If so, modifiers ought to still be passed to
-		 * clients with pointer-focus (see issue #2271)
+		 * This is configurable with <keyboard><modifierBroadcast>,
+		 * which can restrict it to clients with pointer-focus (see
+		 * issue #2271).
 		 */
-		broadcast_modifiers_to_unfocused_clients(seat->seat,
-			&wlr_keyboard->modifiers);
+		schedule_modifier_broadcast(seat, &wlr_keyboard->modifiers);
 	}
 }
 
@@ -181,32 +235,20 @@ static struct keybind *
 match_keybinding_for_sym(struct server *server, uint32_t modifiers,
 		xkb_keysym_t sym, xkb_keycode_t xkb_keycode)
 {
-	struct keybind *keybind;
-	wl_list_for_each(keybind, &rc.keybinds, link) {
-		if (modifiers ^ keybind->modifiers) {
-			continue;
-		}
+	struct wl_array *keybinds =
+		keybind_index_lookup(modifiers, sym, xkb_keycode);
+	if (!keybinds) {
+		return NULL;
+	}
+	struct keybind **keybind;
+	wl_array_for_each(keybind, keybinds) {
 		if (server->seat.nr_inhibited_keybind_views
 				&& server->active_view
 				&& server->active_view->inhibits_keybinds
-				&& !actions_contain_toggle_keybinds(&keybind->actions)) {
+				&& !actions_contain_toggle_keybinds(&(*keybind)->actions)) {
 			continue;
 		}
-		if (sym == XKB_KEY_NoSymbol) {
-			/* Use keycodes */
-			for (size_t i = 0; i < keybind->keycodes_len; i++) {
-				if (keybind->keycodes[i] == xkb_keycode) {
-					return keybind;
-				}
-			}
-		} else {
-			/* Use syms */
-			for (size_t i = 0; i < keybind->keysyms_len; i++) {
-				if (xkb_keysym_to_lower(sym) == keybind->keysyms[i]) {
-					return keybind;
-				}
-			}
-		}
+		return *keybind;
 	}
 	return NULL;
 }
@@ -505,6 +547,7 @@ static enum lab_key_handled
 handle_compositor_keybindings(struct keyboard *keyboard,
 		struct wlr_keyboard_key_event *event)
 {
+	TRACE_SPAN("handle_compositor_keybindings");
 	struct seat *seat = keyboard->base.seat;
 	struct server *server = seat->server;
 	struct wlr_keyboard *wlr_keyboard = keyboard->wlr_keyboard;
@@ -622,6 +665,17 @@ keyboard_cancel_keybind_repeat(struct keyboard *keyboard)
 	}
 }
 
+/* The output most likely to show the response to a key event */
+static struct output *
+get_key_response_output(struct server *server)
+{
+	struct view *view = server->active_view;
+	if (view && output_is_usable(view->output)) {
+		return view->output;
+	}
+	return output_nearest_to_cursor(server);
+}
+
 static void
 keyboard_key_notify(struct wl_listener *listener, void *data)
 {
@@ -632,6 +686,11 @@ keyboard_key_notify(struct wl_listener *listener, void *data)
 	struct wlr_seat *wlr_seat = seat->seat;
 	idle_manager_notify_activity(seat->seat);
 
+	if (rc.latency_probe) {
+		frame_stats_input(get_key_response_output(seat->server),
+			&keyboard->wlr_keyboard->base);
+	}
+
 	/* any new press/release cancels current keybind repeat */
 	keyboard_cancel_keybind_repeat(keyboard);
 
@@ -828,4 +887,8 @@ keyboard_group_finish(struct seat *seat)
 		wlr_keyboard_group_destroy(seat->keyboard_group);
 		seat->keyboard_group = NULL;
 	}
+	if (seat->modifier_broadcast.idle) {
+		wl_event_source_remove(seat->modifier_broadcast.idle);
+		seat->modifier_broadcast.idle = NULL;
+	}
 }
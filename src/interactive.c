@@ -135,6 +135,8 @@ interactive_begin(struct view *view, enum input_mode mode, uint32_t edges)
 	server->grab_y = seat->cursor->y;
 	server->grab_box = view->current;
 	server->resize_edges = edges;
+	server->resize_pending = false;
+	server->move_pending = false;
 
 	/*
 	 * Un-tile maximized/tiled view immediately if <unSnapThreshold> is
@@ -257,9 +259,14 @@ interactive_finish(struct view *view)
 	}
 
 	if (view->server->input_mode == LAB_INPUT_STATE_MOVE) {
+		/* Snap from where the cursor actually is */
+		cursor_flush_move(view->server);
 		if (!snap_to_region(view)) {
 			snap_to_edge(view);
 		}
+	} else if (view->server->resize_pending) {
+		/* Do not lose the final size to configure pacing */
+		view_move_resize(view, view->server->resize_pending_geo);
 	}
 
 	interactive_cancel(view);
@@ -283,7 +290,25 @@ interactive_cancel(struct view *view)
 
 	view->server->input_mode = LAB_INPUT_STATE_PASSTHROUGH;
 	view->server->grabbed_view = NULL;
+	view->server->resize_pending = false;
+	view->server->move_pending = false;
+
+	/* Tell the client where it ended up */
+	view_flush_configure(view);
 
 	/* Update focus/cursor image */
 	cursor_update_focus(view->server);
 }
+
+void
+interactive_resize_configure_done(struct view *view)
+{
+	struct server *server = view->server;
+	if (server->grabbed_view != view || !server->resize_pending
+			|| server->input_mode != LAB_INPUT_STATE_RESIZE
+			|| view->pending_configure_serial) {
+		return;
+	}
+	server->resize_pending = false;
+	view_move_resize(view, server->resize_pending_geo);
+}
@@ -23,6 +23,7 @@ static const struct option long_options[] = {
 	{"help", no_argument, NULL, 'h'},
 	{"merge-config", no_argument, NULL, 'm'},
 	{"reconfigure", no_argument, NULL, 'r'},
+	{"reconfigure-if-changed", no_argument, NULL, 'R'},
 	{"startup", required_argument, NULL, 's'},
 	{"session", required_argument, NULL, 'S'},
 	{"version", no_argument, NULL, 'v'},
@@ -39,6 +40,8 @@ static const char labwc_usage[] =
 "  -h, --help               Show help message and quit\n"
 "  -m, --merge-config       Merge user config files/theme in all XDG Base Dirs\n"
 "  -r, --reconfigure        Reload the compositor configuration\n"
+"  -R, --reconfigure-if-changed\n"
+"                           Reload only if configuration files have changed\n"
 "  -s, --startup <command>  Run command on startup\n"
 "  -S, --session <command>  Run command on startup and terminate on exit\n"
 "  -v, --version            Show version number and quit\n"
@@ -119,7 +122,7 @@ main(int argc, char *argv[])
 	int c;
 	while (1) {
 		int index = 0;
-		c = getopt_long(argc, argv, "c:C:dehmrs:S:vV", long_options, &index);
+		c = getopt_long(argc, argv, "c:C:dehmrRs:S:vV", long_options, &index);
 		if (c == -1) {
 			break;
 		}
@@ -142,6 +145,9 @@ main(int argc, char *argv[])
 		case 'r':
 			send_signal_to_labwc_pid(SIGHUP);
 			exit(0);
+		case 'R':
+			send_signal_to_labwc_pid(SIGUSR1);
+			exit(0);
 		case 's':
 			startup_cmd = optarg;
 			break;
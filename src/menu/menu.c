@@ -14,6 +14,7 @@
 #include "common/buf.h"
 #include "common/dir.h"
 #include "common/font.h"
+#include "common/grab-file.h"
 #include "common/list.h"
 #include "common/mem.h"
 #include "common/nodename.h"
@@ -734,18 +735,7 @@ parse_buf(struct server *server, struct buf *buf)
 static void
 parse_stream(struct server *server, FILE *stream)
 {
-	char *line = NULL;
-	size_t len = 0;
-	struct buf b = BUF_INIT;
-
-	while (getline(&line, &len, stream) != -1) {
-		char *p = strrchr(line, '\n');
-		if (p) {
-			*p = '\0';
-		}
-		buf_add(&b, line);
-	}
-	free(line);
+	struct buf b = grab_stream(stream);
 	parse_buf(server, &b);
 	buf_reset(&b);
 }
@@ -16,12 +16,15 @@
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_xdg_output_v1.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
 #include <wlr/util/region.h>
 #include <wlr/util/log.h>
 #include "common/direction.h"
 #include "common/macros.h"
 #include "common/mem.h"
 #include "common/scene-helpers.h"
+#include "frame-stats.h"
+#include "frame-throttle.h"
 #include "labwc.h"
 #include "layers.h"
 #include "node.h"
@@ -29,6 +32,7 @@
 #include "output-virtual.h"
 #include "protocols/cosmic-workspaces.h"
 #include "regions.h"
+#include "trace.h"
 #include "view.h"
 #include "xwayland.h"
 
@@ -103,6 +107,138 @@ output_apply_gamma(struct output *output)
 	wlr_output_state_finish(&pending);
 }
 
+/* Returns the topmost view on @output if it is fullscreen there */
+static struct view *
+get_top_fullscreen_view(struct output *output)
+{
+	struct view *view;
+	for_each_view(view, &output->server->views,
+			LAB_VIEW_CRITERIA_CURRENT_WORKSPACE) {
+		if (view->minimized || !view_on_output(view, output)) {
+			continue;
+		}
+		if (view->fullscreen && view->output == output) {
+			return view;
+		}
+		return NULL;
+	}
+	return NULL;
+}
+
+struct scanout_blocker {
+	struct wlr_box output_box;
+	struct wlr_scene_node *fullscreen;
+	/* Topmost visible node above the fullscreen view, if any */
+	struct wlr_scene_node *node;
+	struct wlr_box box;
+};
+
+/* Walks the scene top to bottom, returns true when done */
+static bool
+find_scanout_blocker(struct wlr_scene_node *node, int x, int y,
+		struct scanout_blocker *blocker)
+{
+	if (node == blocker->fullscreen) {
+		return true;
+	}
+	if (!node->enabled) {
+		return false;
+	}
+	x += node->x;
+	y += node->y;
+
+	struct wlr_box box = { .x = x, .y = y };
+	switch (node->type) {
+	case WLR_SCENE_NODE_TREE: {
+		struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
+		struct wlr_scene_node *child;
+		wl_list_for_each_reverse(child, &tree->children, link) {
+			if (find_scanout_blocker(child, x, y, blocker)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	case WLR_SCENE_NODE_RECT: {
+		struct wlr_scene_rect *rect = wlr_scene_rect_from_node(node);
+		if (rect->color[3] == 0.0f) {
+			/* Invisible rects are ignored by wlr_scene as well */
+			return false;
+		}
+		box.width = rect->width;
+		box.height = rect->height;
+		break;
+	}
+	case WLR_SCENE_NODE_BUFFER: {
+		struct wlr_scene_buffer *buffer = wlr_scene_buffer_from_node(node);
+		if (!buffer->buffer) {
+			return false;
+		}
+		box.width = buffer->dst_width
+			? buffer->dst_width : buffer->buffer->width;
+		box.height = buffer->dst_height
+			? buffer->dst_height : buffer->buffer->height;
+		break;
+	}
+	}
+
+	if (!wlr_box_intersection(&box, &box, &blocker->output_box)) {
+		return false;
+	}
+	blocker->node = node;
+	blocker->box = box;
+	return true;
+}
+
+/*
+ * Fullscreen views are drawn without decorations and hide the top layer,
+ * OSDs and menus are disabled while they are not shown. So a fullscreen
+ * view on top of the output is expected to be scanned out directly if
+ * its buffer allows for it. Log what gets in the way when it is not, in
+ * order to catch nodes which are left enabled but are not visible.
+ */
+static void
+update_direct_scanout(struct output *output)
+{
+	/* Private wlroots state, see lab_wlr_scene_output_commit() */
+	bool scanout = output->scene_output->prev_scanout;
+	struct view *view = get_top_fullscreen_view(output);
+	if (scanout == output->direct_scanout
+			&& !!view == output->fullscreen_on_top) {
+		return;
+	}
+	output->direct_scanout = scanout;
+	output->fullscreen_on_top = view;
+	if (scanout || !view) {
+		return;
+	}
+
+	struct scanout_blocker blocker = {
+		.fullscreen = &view->scene_tree->node,
+	};
+	wlr_output_layout_get_box(output->server->output_layout,
+		output->wlr_output, &blocker.output_box);
+	find_scanout_blocker(&output->server->scene->tree.node, 0, 0,
+		&blocker);
+
+	if (!blocker.node) {
+		wlr_log(WLR_DEBUG, "%s: fullscreen view is composited, "
+			"its buffer is not suitable for direct scanout",
+			output->wlr_output->name);
+		return;
+	}
+	const char *type = "buffer";
+	if (blocker.node->type == WLR_SCENE_NODE_RECT) {
+		type = "rect";
+	} else if (lab_wlr_surface_from_node(blocker.node)) {
+		type = "surface";
+	}
+	wlr_log(WLR_DEBUG, "%s: fullscreen view is composited, "
+		"%s at %d,%d (%dx%d) is shown above it",
+		output->wlr_output->name, type, blocker.box.x, blocker.box.y,
+		blocker.box.width, blocker.box.height);
+}
+
 static void
 output_frame_notify(struct wl_listener *listener, void *data)
 {
@@ -110,11 +246,17 @@ output_frame_notify(struct wl_listener *listener, void *data)
 	 * This function is called every time an output is ready to display a
 	 * frame - which is typically at 60 Hz.
 	 */
+	TRACE_SPAN("output_frame_notify");
 	struct output *output = wl_container_of(listener, output, frame);
 	if (!output_is_usable(output)) {
 		return;
 	}
 
+	frame_stats_frame_begin(output->frame_stats);
+
+	/* Apply cursor motion accumulated during interactive move */
+	cursor_flush_move(output->server);
+
 	if (!output->scene_output) {
 		/*
 		 * TODO: This is a short term fix for issue #1667,
@@ -141,12 +283,14 @@ output_frame_notify(struct wl_listener *listener, void *data)
 
 		pending->tearing_page_flip = output_get_tearing_allowance(output);
 
-		lab_wlr_scene_output_commit(scene_output, pending);
+		if (lab_wlr_scene_output_commit(scene_output, pending)) {
+			update_direct_scanout(output);
+		}
 	}
 
 	struct timespec now = { 0 };
 	clock_gettime(CLOCK_MONOTONIC, &now);
-	wlr_scene_output_send_frame_done(output->scene_output, &now);
+	frame_throttle_send_frame_done(output, &now);
 }
 
 static void
@@ -161,6 +305,7 @@ output_destroy_notify(struct wl_listener *listener, void *data)
 	}
 	wl_list_remove(&output->link);
 	wl_list_remove(&output->frame.link);
+	wl_list_remove(&output->present.link);
 	wl_list_remove(&output->destroy.link);
 	wl_list_remove(&output->request_state.link);
 	seat_output_layout_changed(seat);
@@ -185,6 +330,8 @@ output_destroy_notify(struct wl_listener *listener, void *data)
 	}
 
 	wlr_output_state_finish(&output->pending);
+	frame_stats_destroy(output->frame_stats);
+	frame_throttle_output_finish(output);
 
 	/*
 	 * Ensure that we don't accidentally try to dereference
@@ -200,6 +347,13 @@ output_destroy_notify(struct wl_listener *listener, void *data)
 	free(output);
 }
 
+static void
+output_present_notify(struct wl_listener *listener, void *data)
+{
+	struct output *output = wl_container_of(listener, output, present);
+	frame_stats_presented(output->frame_stats, data);
+}
+
 static void
 output_request_state_notify(struct wl_listener *listener, void *data)
 {
@@ -343,6 +497,7 @@ new_output_notify(struct wl_listener *listener, void *data)
 	output->wlr_output = wlr_output;
 	wlr_output->data = output;
 	output->server = server;
+	output->frame_stats = frame_stats_create();
 	output_state_init(output);
 
 	wlr_log(WLR_DEBUG, "enable output");
@@ -398,6 +553,8 @@ new_output_notify(struct wl_listener *listener, void *data)
 	wl_signal_add(&wlr_output->events.destroy, &output->destroy);
 	output->frame.notify = output_frame_notify;
 	wl_signal_add(&wlr_output->events.frame, &output->frame);
+	output->present.notify = output_present_notify;
+	wl_signal_add(&wlr_output->events.present, &output->present);
 
 	output->request_state.notify = output_request_state_notify;
 	wl_signal_add(&wlr_output->events.request_state, &output->request_state);
@@ -943,9 +1100,11 @@ output_update_usable_area(struct output *output)
 	if (update_usable_area(output)) {
 		regions_update_geometry(output);
 #if HAVE_XWAYLAND
-		xwayland_update_workarea(output->server);
+		if (xwayland_output_affects_workarea(output)) {
+			xwayland_update_workarea(output->server);
+		}
 #endif
-		desktop_arrange_all_views(output->server);
+		desktop_arrange_views_on_output(output);
 	}
 }
 
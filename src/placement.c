@@ -1,7 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #include <assert.h>
-#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include "common/macros.h"
 #include "common/mem.h"
@@ -10,8 +10,7 @@
 #include "ssd.h"
 #include "view.h"
 
-#define overlap_bitmap_index(bmp, i, j) \
-	(bmp)->grid[i * ((bmp)->nr_cols - 1) + j]
+#define grid_index(bmp, i, j) ((i) * ((bmp)->nr_cols - 1) + (j))
 
 struct overlap_bitmap {
 	int nr_rows;
@@ -19,6 +18,27 @@ struct overlap_bitmap {
 	int *rows;
 	int *cols;
 	int *grid;
+
+	/* Prefix sums of the overlap, see build_prefix_sums() */
+	int64_t *area_sums;
+	int64_t *height_sums;
+	int64_t *width_sums;
+};
+
+/*
+ * Extent of a candidate region along one axis, starting from a given grid
+ * interval and extending either forward (right/down) or backward.
+ */
+struct span {
+	int lo;
+	int hi;
+	/* Intervals with edges[lo_cell] <= lo and hi <= edges[hi_cell + 1] */
+	int lo_cell;
+	int hi_cell;
+	/* False if the region extends beyond the usable area */
+	bool valid;
+	/* True if the region fits within its starting interval */
+	bool single;
 };
 
 static int
@@ -35,6 +55,9 @@ destroy_bitmap(struct overlap_bitmap *bmp)
 	zfree(bmp->rows);
 	zfree(bmp->cols);
 	zfree(bmp->grid);
+	zfree(bmp->area_sums);
+	zfree(bmp->height_sums);
+	zfree(bmp->width_sums);
 
 	bmp->nr_rows = 0;
 	bmp->nr_cols = 0;
@@ -238,7 +261,7 @@ build_overlap(struct overlap_bitmap *bmp, struct view *view)
 
 	struct server *server = view->server;
 
-	if (bmp->nr_rows < 1 || bmp->nr_cols < 1) {
+	if (bmp->nr_rows < 2 || bmp->nr_cols < 2) {
 		return;
 	}
 
@@ -247,6 +270,10 @@ build_overlap(struct overlap_bitmap *bmp, struct view *view)
 		return;
 	}
 
+	/* Number of row and column intervals */
+	int nri = bmp->nr_rows - 1;
+	int nci = bmp->nr_cols - 1;
+
 	struct view *v;
 	for_each_view(v, &server->views, LAB_VIEW_CRITERIA_CURRENT_WORKSPACE) {
 		if (v == view || v->output != output) {
@@ -293,105 +320,170 @@ build_overlap(struct overlap_bitmap *bmp, struct view *view)
 		lc = MIN(bmp->nr_cols - 1, lc + 1);
 		lr = MIN(bmp->nr_rows - 1, lr + 1);
 
+		if (fr >= lr || fc >= lc) {
+			continue;
+		}
+
 		/*
 		 * Every interval in the region [fr, lr) x [fc, lc) is
-		 * completely covered by the view. Increment the overlap
-		 * counters these intervals to account for the view.
+		 * completely covered by the view. Mark the corners of the
+		 * region so that the prefix sums below increment the overlap
+		 * counters of exactly these intervals.
 		 */
-		for (int i = fr; i < lr; ++i) {
-			for (int j = fc; j < lc; ++j) {
-				overlap_bitmap_index(bmp, i, j) += 1;
-			}
+		bmp->grid[grid_index(bmp, fr, fc)] += 1;
+		if (lc < nci) {
+			bmp->grid[grid_index(bmp, fr, lc)] -= 1;
+		}
+		if (lr < nri) {
+			bmp->grid[grid_index(bmp, lr, fc)] -= 1;
+		}
+		if (lr < nri && lc < nci) {
+			bmp->grid[grid_index(bmp, lr, lc)] += 1;
+		}
+	}
+
+	for (int i = 0; i < nri; ++i) {
+		for (int j = 1; j < nci; ++j) {
+			bmp->grid[grid_index(bmp, i, j)] +=
+				bmp->grid[grid_index(bmp, i, j - 1)];
+		}
+	}
+	for (int i = 1; i < nri; ++i) {
+		for (int j = 0; j < nci; ++j) {
+			bmp->grid[grid_index(bmp, i, j)] +=
+				bmp->grid[grid_index(bmp, i - 1, j)];
 		}
 	}
 }
 
 /*
- * Find the total overlap of an arbitrary region of a given width and height
- * with intervals in a pre-computed overlap bitmap. The starting interval for
- * the region is (i, j) in the bitmap grid. If the region is larger than
- * interval (i, j), neighboring regions will be considered width-wise rightward
- * (when right is true) or leftward (otherwise) and height-wise downward (when
- * down is true) or upward (otherwise).
+ * Build a summed-area table of the overlap bitmap so that the total overlap
+ * of any region can be computed in constant time by compute_overlap().
  *
- * If the region would extend beyond the edges of the grid (i.e., beyond the
- * usable region of an output) in the prescribed directions, an overlap of
- * INT_MAX is returned. Otherwise, the overlap is the sum of the areas of each
- * interval covered by the region multiplied by its overlap count. For example,
- * an interval currently covered by three windows will be triply counted in the
- * overlap sum.
+ * For interval (i, j), area_sums holds the overlap of all intervals above
+ * and to the left of it, i.e. [0, i) x [0, j), weighted by their areas.
+ * height_sums holds the overlap of the intervals [0, i) in column j per unit
+ * of width and width_sums the overlap of the intervals [0, j) in row i per
+ * unit of height. Together with the overlap count of the interval itself,
+ * this yields the overlap of the region from the top-left corner of the
+ * grid to any point within the interval, see overlap_before().
  */
-static int
-compute_overlap(struct overlap_bitmap *bmp, int i, int j,
-		int width, int height, bool right, bool down, bool *single)
+static void
+build_prefix_sums(struct overlap_bitmap *bmp)
 {
-	/*
-	 * The number of row or column intervals is one less than corresponding
-	 * number of row or column grid points.
-	 */
-	int nri = bmp->nr_rows - 1;
-	int nci = bmp->nr_cols - 1;
-
-	int i_incr = down ? 1 : -1;
-	int j_incr = right ? 1 : -1;
-
-	int overlap = 0;
-	int count = 0;
-
-	/* Walk up or down along rows according to preference */
-	for (int ii = i; ii >= 0 && ii < nri && height > 0; ii += i_incr) {
-		/* Height of this row */
-		int rh = bmp->rows[ii + 1] - bmp->rows[ii];
-
-		/* Height of overlap between this row and test region */
-		int mh = MAX(0, MIN(height, rh));
+	assert(bmp);
 
-		/* Remaining height to consider for next row */
-		height -= rh;
+	if (bmp->nr_rows < 2 || bmp->nr_cols < 2) {
+		return;
+	}
 
-		/* Walk left or right along columns according to preference */
-		int ww = width;
-		for (int jj = j; jj >= 0 && jj < nci && ww > 0; jj += j_incr) {
-			/* Width of this column */
-			int cw = bmp->cols[jj + 1] - bmp->cols[jj];
+	int nri = bmp->nr_rows - 1;
+	int nci = bmp->nr_cols - 1;
+	size_t grid_size = (size_t)nri * nci;
 
-			/* Width of overlap between this column and test region */
-			int mw = MAX(0, MIN(ww, cw));
+	bmp->area_sums = xzalloc(grid_size * sizeof(int64_t));
+	bmp->height_sums = xzalloc(grid_size * sizeof(int64_t));
+	bmp->width_sums = xzalloc(grid_size * sizeof(int64_t));
 
-			/* Add overlap contribution for this interval */
-			overlap += overlap_bitmap_index(bmp, ii, jj) * mh * mw;
+	for (int i = 0; i < nri; ++i) {
+		for (int j = 0; j < nci; ++j) {
+			int k = grid_index(bmp, i, j);
+			if (i > 0) {
+				int up = grid_index(bmp, i - 1, j);
+				int rh = bmp->rows[i] - bmp->rows[i - 1];
+				bmp->height_sums[k] = bmp->height_sums[up]
+					+ (int64_t)bmp->grid[up] * rh;
+			}
+			if (j > 0) {
+				int left = grid_index(bmp, i, j - 1);
+				int cw = bmp->cols[j] - bmp->cols[j - 1];
+				bmp->width_sums[k] = bmp->width_sums[left]
+					+ (int64_t)bmp->grid[left] * cw;
+				bmp->area_sums[k] = bmp->area_sums[left]
+					+ bmp->height_sums[left] * cw;
+			}
+		}
+	}
+}
 
-			/* Count the number of overlapping intervals */
-			count++;
+/*
+ * Overlap of the region from the top-left corner of the grid to (x, y),
+ * where x lies within column interval j and y within row interval i.
+ */
+static int64_t
+overlap_before(struct overlap_bitmap *bmp, int i, int j, int x, int y)
+{
+	int k = grid_index(bmp, i, j);
+	int64_t dx = x - bmp->cols[j];
+	int64_t dy = y - bmp->rows[i];
 
-			/* Remaining width to consider for next column */
-			ww -= cw;
-		}
+	return bmp->area_sums[k] + dx * bmp->height_sums[k]
+		+ dy * bmp->width_sums[k] + dx * dy * bmp->grid[k];
+}
 
-		/*
-		 * If there is width left to consider after walking columns,
-		 * the region extends out of bounds and placement is invalid.
-		 */
-		if (ww > 0) {
-			overlap = INT_MAX;
-			break;
-		}
-	}
+/* Find the interval containing val, clipped to the intervals of the grid */
+static int
+find_cell(int *edges, int nedges, int val)
+{
+	int j = find_interval(edges, nedges, val);
+	return MAX(0, MIN(j, nedges - 2));
+}
 
-	/*
-	 * If there is height left ot consider after walking rows, the region
-	 * extends out of bounds and placement is invalid.
-	 */
-	if (height > 0) {
-		overlap = INT_MAX;
+/*
+ * Compute the spans of a region of the given size starting from each of the
+ * (nedges - 1) intervals of a 1-D grid. Forward spans place the low edge of
+ * the region on the low edge of the interval, backward spans place the high
+ * edge of the region on the high edge of the interval.
+ */
+static void
+find_spans(int *edges, int nedges, int size,
+		struct span *forward, struct span *backward)
+{
+	int first = edges[0];
+	int last = edges[nedges - 1];
+
+	for (int k = 0; k < nedges - 1; ++k) {
+		bool single = size <= edges[k + 1] - edges[k];
+
+		struct span *fw = &forward[k];
+		fw->lo = edges[k];
+		fw->hi = edges[k] + size;
+		fw->lo_cell = k;
+		fw->valid = fw->hi <= last;
+		fw->hi_cell = fw->valid ? find_cell(edges, nedges, fw->hi) : k;
+		fw->single = single;
+
+		struct span *bw = &backward[k];
+		bw->hi = edges[k + 1];
+		bw->lo = edges[k + 1] - size;
+		bw->hi_cell = k;
+		bw->valid = bw->lo >= first;
+		bw->lo_cell = bw->valid ? find_cell(edges, nedges, bw->lo) : k;
+		bw->single = single;
 	}
+}
 
-	/* Indicate whether overlap is confined to a single region */
-	if (single) {
-		*single = (count == 1);
+/*
+ * Find the total overlap of the region spanned by x and y with intervals in
+ * the pre-computed overlap bitmap.
+ *
+ * If the region would extend beyond the edges of the grid (i.e., beyond the
+ * usable region of an output), an overlap of INT64_MAX is returned. Otherwise,
+ * the overlap is the sum of the areas of each interval covered by the region
+ * multiplied by its overlap count. For example, an interval currently covered
+ * by three windows will be triply counted in the overlap sum.
+ */
+static int64_t
+compute_overlap(struct overlap_bitmap *bmp, struct span *x, struct span *y)
+{
+	if (!x->valid || !y->valid) {
+		return INT64_MAX;
 	}
 
-	return overlap;
+	return overlap_before(bmp, y->hi_cell, x->hi_cell, x->hi, y->hi)
+		- overlap_before(bmp, y->hi_cell, x->lo_cell, x->lo, y->hi)
+		- overlap_before(bmp, y->lo_cell, x->hi_cell, x->hi, y->lo)
+		+ overlap_before(bmp, y->lo_cell, x->lo_cell, x->lo, y->lo);
 }
 
 /*
@@ -421,6 +513,7 @@ placement_find_best(struct view *view, struct wlr_box *geometry)
 	struct overlap_bitmap bmp = { 0 };
 	build_grid(&bmp, view);
 	build_overlap(&bmp, view);
+	build_prefix_sums(&bmp);
 
 	/* Dimensions include gap along all edges to ensure proper separation */
 	int height = geometry->height + margin.top + margin.bottom + 2 * rc.gap;
@@ -433,10 +526,24 @@ placement_find_best(struct view *view, struct wlr_box *geometry)
 	int offset_x = margin.left + rc.gap;
 	int offset_y = margin.top + rc.gap;
 
-	int min_overlap = INT_MAX;
+	int64_t min_overlap = INT64_MAX;
 
 	int nri = bmp.nr_rows - 1;
 	int nci = bmp.nr_cols - 1;
+	if (nri < 1 || nci < 1) {
+		goto final_placement;
+	}
+
+	/*
+	 * The horizontal extent of a candidate only depends on the column
+	 * and the direction, the vertical extent only on the row.
+	 */
+	struct span *right = znew_n(struct span, nci);
+	struct span *left = znew_n(struct span, nci);
+	struct span *down = znew_n(struct span, nri);
+	struct span *up = znew_n(struct span, nri);
+	find_spans(bmp.cols, bmp.nr_cols, width, right, left);
+	find_spans(bmp.rows, bmp.nr_rows, height, down, up);
 
 	/*
 	 * Convolve the view region with the overlap grid to determine the
@@ -473,12 +580,11 @@ placement_find_best(struct view *view, struct wlr_box *geometry)
 				/* Up/down is determined by second bit */
 				bool dn = (ii & 0x2) == 0;
 
-				/* Track whether overlap comes from single region */
-				bool single = false;
+				struct span *x = rt ? &right[j] : &left[j];
+				struct span *y = dn ? &down[i] : &up[i];
 
 				/* Compute overlap in specified direction */
-				int overlap = compute_overlap(&bmp, i, j,
-					width, height, rt, dn, &single);
+				int64_t overlap = compute_overlap(&bmp, x, y);
 
 				/* Move on if overlap isn't reduced */
 				if (overlap >= min_overlap) {
@@ -488,40 +594,35 @@ placement_find_best(struct view *view, struct wlr_box *geometry)
 				/* Place window in optimal direction */
 				min_overlap = overlap;
 
-				if (rt) {
-					/* Extend window right from left edge */
-					geometry->x = bmp.cols[j] + offset_x;
-				} else {
-					/* Extend window left from right edge */
-					geometry->x =
-						bmp.cols[j + 1] - width + offset_x;
-				}
-
-				if (dn) {
-					/* Extend window down from top edge */
-					geometry->y = bmp.rows[i] + offset_y;
-				} else {
-					/* Extend window up from bottom edge */
-					geometry->y =
-						bmp.rows[i + 1] - height + offset_y;
-				}
+				/*
+				 * The spans already extend right or left from
+				 * the left or right edge of the interval (and
+				 * likewise down or up).
+				 */
+				geometry->x = x->lo + offset_x;
+				geometry->y = y->lo + offset_y;
 
 				/* If there is no overlap, the search is done. */
 				if (min_overlap <= 0) {
-					goto final_placement;
+					goto free_spans;
 				}
 
 				/*
 				 * Skip multi-directional searches when the
 				 * view fits completely within one region.
 				 */
-				if (single) {
+				if (x->single && y->single) {
 					break;
 				}
 			}
 		}
 	}
 
+free_spans:
+	free(right);
+	free(left);
+	free(down);
+	free(up);
 final_placement:
 	destroy_bitmap(&bmp);
 	return true;
@@ -23,9 +23,13 @@
 #include "xwayland-shell-v1-protocol.h"
 #endif
 #include "drm-lease-v1-protocol.h"
+#include "common/dir.h"
+#include "common/file-helpers.h"
 #include "config/rcxml.h"
 #include "config/session.h"
 #include "decorations.h"
+#include "frame-stats.h"
+#include "frame-throttle.h"
 #if HAVE_LIBSFDO
 #include "icon-loader.h"
 #endif
@@ -39,6 +43,7 @@
 #include "regions.h"
 #include "resize-indicator.h"
 #include "theme.h"
+#include "trace.h"
 #include "view.h"
 #include "workspaces.h"
 #include "xwayland.h"
@@ -49,17 +54,87 @@
 
 static struct wlr_compositor *compositor;
 static struct wl_event_source *sighup_source;
+static struct wl_event_source *sigusr1_source;
 static struct wl_event_source *sigint_source;
 static struct wl_event_source *sigterm_source;
 static struct wl_event_source *sigchld_source;
 
+/*
+ * Fingerprints of the files read on startup and reconfigure. These allow us
+ * to skip reloading (and re-decorating every window) when SIGUSR1 is received
+ * but none of the files have changed.
+ */
+static struct {
+	uint64_t config;
+	uint64_t theme;
+	uint64_t menu;
+} fingerprints;
+
+static uint64_t
+config_paths_fingerprint(uint64_t hash, const char *filename)
+{
+	struct wl_list paths;
+	paths_config_create(&paths, filename);
+	struct path *path;
+	wl_list_for_each(path, &paths, link) {
+		hash = file_fingerprint(hash, path->string);
+	}
+	paths_destroy(&paths);
+	return hash;
+}
+
+static uint64_t
+theme_paths_fingerprint(uint64_t hash)
+{
+	/* Include whole theme directories to catch button image changes */
+	struct wl_list paths;
+	paths_theme_create(&paths, rc.theme_name, "themerc");
+	struct path *path;
+	wl_list_for_each(path, &paths, link) {
+		char *p = strrchr(path->string, '/');
+		if (p) {
+			*p = '\0';
+			hash = dir_fingerprint(hash, path->string);
+		}
+	}
+	paths_destroy(&paths);
+	return config_paths_fingerprint(hash, "themerc-override");
+}
+
+/* Returns true if rc.xml, environment or theme files have changed */
+static bool
+update_fingerprints(bool *menu_changed)
+{
+	uint64_t config = rc.config_file
+		? file_fingerprint(FINGERPRINT_INIT, rc.config_file)
+		: config_paths_fingerprint(FINGERPRINT_INIT, "rc.xml");
+	/* For example keyboard layout and cursor theme */
+	config = config_paths_fingerprint(config, "environment");
+	uint64_t theme = theme_paths_fingerprint(FINGERPRINT_INIT);
+	uint64_t menu = config_paths_fingerprint(FINGERPRINT_INIT, "menu.xml");
+
+	bool changed = config != fingerprints.config
+		|| theme != fingerprints.theme;
+	if (menu_changed) {
+		*menu_changed = menu != fingerprints.menu;
+	}
+
+	fingerprints.config = config;
+	fingerprints.theme = theme;
+	fingerprints.menu = menu;
+	return changed;
+}
+
 static void
 reload_config_and_theme(struct server *server)
 {
+	TRACE_SPAN("reload_config_and_theme");
 	rcxml_finish();
 	rcxml_read(rc.config_file);
 	theme_finish(server->theme);
 	theme_init(server->theme, server, rc.theme_name);
+	/* The theme name may have changed with rc.xml */
+	fingerprints.theme = theme_paths_fingerprint(FINGERPRINT_INIT);
 
 #if HAVE_LIBSFDO
 	icon_loader_finish(server);
@@ -77,6 +152,7 @@ reload_config_and_theme(struct server *server)
 	resize_indicator_reconfigure(server);
 	kde_server_decoration_update_default();
 	workspaces_reconfigure(server);
+	frame_throttle_reconfigure(server);
 }
 
 static int
@@ -84,12 +160,50 @@ handle_sighup(int signal, void *data)
 {
 	struct server *server = data;
 
+	/*
+	 * Always reload everything. The fingerprints only cover labwc's own
+	 * files, not for example XKB files or cursor, icon and font themes.
+	 */
 	session_environment_init();
+	update_fingerprints(NULL);
 	reload_config_and_theme(server);
 	output_virtual_update_fallback(server);
 	return 0;
 }
 
+static int
+handle_sigusr1(int signal, void *data)
+{
+	struct server *server = data;
+
+	session_environment_init();
+
+	/*
+	 * The fingerprints are taken before reading the files so that changes
+	 * made while we are reading them are picked up on the next signal.
+	 */
+	bool menu_changed;
+	if (update_fingerprints(&menu_changed)) {
+		reload_config_and_theme(server);
+	} else {
+		/*
+		 * rc.xml and the theme are unchanged, so keep the current
+		 * decorations. The icon loader is still refreshed to pick
+		 * up newly installed applications and icons.
+		 */
+		wlr_log(WLR_INFO, "config and theme unchanged, not reloading");
+#if HAVE_LIBSFDO
+		icon_loader_finish(server);
+		icon_loader_init(server);
+#endif
+		if (menu_changed) {
+			menu_reconfigure(server);
+		}
+	}
+	output_virtual_update_fallback(server);
+	return 0;
+}
+
 static int
 handle_sigterm(int signal, void *data)
 {
@@ -317,11 +431,16 @@ server_init(struct server *server)
 
 	wl_display_set_global_filter(server->wl_display, server_global_filter, server);
 
+	/* rc.xml has been read by now, and theme and menu will follow shortly */
+	update_fingerprints(NULL);
+
 	/* Catch SIGHUP */
 	struct wl_event_loop *event_loop = NULL;
 	event_loop = wl_display_get_event_loop(server->wl_display);
 	sighup_source = wl_event_loop_add_signal(
 		event_loop, SIGHUP, handle_sighup, server);
+	sigusr1_source = wl_event_loop_add_signal(
+		event_loop, SIGUSR1, handle_sigusr1, server);
 	sigint_source = wl_event_loop_add_signal(
 		event_loop, SIGINT, handle_sigterm, server->wl_display);
 	sigterm_source = wl_event_loop_add_signal(
@@ -575,6 +694,7 @@ server_init(struct server *server)
 	server->tablet_manager = wlr_tablet_v2_create(server->wl_display);
 
 	layers_init(server);
+	frame_throttle_reconfigure(server);
 
 #if HAVE_LIBSFDO
 	icon_loader_init(server);
@@ -623,13 +743,22 @@ server_finish(struct server *server)
 	if (sighup_source) {
 		wl_event_source_remove(sighup_source);
 	}
+	if (sigusr1_source) {
+		wl_event_source_remove(sigusr1_source);
+	}
 	wl_display_destroy_clients(server->wl_display);
 
+	if (server->map_batch.idle) {
+		wl_event_source_remove(server->map_batch.idle);
+		server->map_batch.idle = NULL;
+	}
+	frame_throttle_finish(server);
 	seat_finish(server);
 	wl_display_destroy(server->wl_display);
 
 	/* TODO: clean up various scene_tree nodes */
 	workspaces_destroy(server);
+	frame_stats_finish();
 
 #if HAVE_LIBSFDO
 	icon_loader_finish(server);
@@ -174,6 +174,27 @@ ssd_border_update(struct ssd *ssd)
 	} FOR_EACH_END
 }
 
+void
+ssd_border_reconfigure(struct ssd *ssd)
+{
+	assert(ssd);
+	assert(ssd->border.tree);
+
+	struct theme *theme = ssd->view->server->theme;
+
+	struct ssd_part *part;
+	struct ssd_sub_tree *subtree;
+	FOR_EACH_STATE(ssd, subtree) {
+		float *color = subtree == &ssd->border.active
+			? theme->window_active_border_color
+			: theme->window_inactive_border_color;
+		wl_list_for_each(part, &subtree->parts, link) {
+			wlr_scene_rect_set_color(
+				wlr_scene_rect_from_node(part->node), color);
+		}
+	} FOR_EACH_END
+}
+
 void
 ssd_border_destroy(struct ssd *ssd)
 {
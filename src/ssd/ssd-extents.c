@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <pixman.h>
+#include "common/box.h"
 #include "common/mem.h"
 #include "common/scene-helpers.h"
 #include "labwc.h"
@@ -53,10 +54,48 @@ ssd_extents_create(struct ssd *ssd)
 	ssd_extents_update(ssd);
 }
 
+/* Layout box covered by all extent parts together */
+static struct wlr_box
+get_extents_box(struct ssd *ssd)
+{
+	struct view *view = ssd->view;
+	int border = view->server->theme->border_width + SSD_EXTENDED_AREA;
+	int height = view_effective_height(view, /* use_pending */ false);
+	return (struct wlr_box){
+		.x = view->current.x - border,
+		.y = view->current.y - ssd->titlebar.height - border,
+		.width = view->current.width + 2 * border,
+		.height = height + ssd->titlebar.height + 2 * border,
+	};
+}
+
+/*
+ * Returns true if the extents are fully inside the usable area of the
+ * view's output, in which case none of the parts is clipped.
+ */
+static bool
+extents_fit_output(struct ssd *ssd)
+{
+	struct view *view = ssd->view;
+	if (!output_is_usable(view->output)) {
+		return false;
+	}
+	struct wlr_box usable = output_usable_area_in_layout_coords(view->output);
+	struct wlr_box box = get_extents_box(ssd);
+	return box_contains(&usable, &box);
+}
+
+bool
+ssd_extents_may_clip(struct ssd *ssd)
+{
+	return !ssd->state.extents_unclipped || !extents_fit_output(ssd);
+}
+
 void
 ssd_extents_update(struct ssd *ssd)
 {
 	struct view *view = ssd->view;
+	ssd->state.extents_unclipped = false;
 	if (view->fullscreen || view->maximized == VIEW_AXIS_BOTH) {
 		wlr_scene_node_set_enabled(&ssd->extents.tree->node, false);
 		return;
@@ -235,6 +274,8 @@ ssd_extents_update(struct ssd *ssd)
 	}
 	pixman_region32_fini(&intersection);
 	pixman_region32_fini(&usable);
+
+	ssd->state.extents_unclipped = extents_fit_output(ssd);
 }
 
 void
@@ -309,6 +309,56 @@ ssd_shadow_update(struct ssd *ssd)
 	}
 }
 
+void
+ssd_shadow_reconfigure(struct ssd *ssd)
+{
+	assert(ssd);
+	assert(ssd->shadow.tree);
+
+	struct theme *theme = ssd->view->server->theme;
+
+	struct ssd_part *part;
+	struct ssd_sub_tree *subtree;
+	FOR_EACH_STATE(ssd, subtree) {
+		if (!subtree->tree) {
+			continue;
+		}
+		bool active = subtree == &ssd->shadow.active;
+		struct lab_data_buffer *corner_top = active
+			? theme->shadow_corner_top_active
+			: theme->shadow_corner_top_inactive;
+		struct lab_data_buffer *corner_bottom = active
+			? theme->shadow_corner_bottom_active
+			: theme->shadow_corner_bottom_inactive;
+		struct lab_data_buffer *edge = active
+			? theme->shadow_edge_active
+			: theme->shadow_edge_inactive;
+
+		/* Same shadow size, so only the colors may have changed */
+		wl_list_for_each(part, &subtree->parts, link) {
+			struct lab_data_buffer *buffer;
+			switch (part->type) {
+			case LAB_SSD_PART_CORNER_TOP_LEFT:
+			case LAB_SSD_PART_CORNER_TOP_RIGHT:
+				buffer = corner_top;
+				break;
+			case LAB_SSD_PART_CORNER_BOTTOM_LEFT:
+			case LAB_SSD_PART_CORNER_BOTTOM_RIGHT:
+				buffer = corner_bottom;
+				break;
+			default:
+				buffer = edge;
+				break;
+			}
+			wlr_scene_buffer_set_buffer(
+				wlr_scene_buffer_from_node(part->node),
+				&buffer->base);
+		}
+	} FOR_EACH_END
+
+	ssd_shadow_update(ssd);
+}
+
 void
 ssd_shadow_destroy(struct ssd *ssd)
 {
@@ -333,6 +333,119 @@ ssd_titlebar_update(struct ssd *ssd)
 	ssd_update_window_icon(ssd);
 }
 
+/*
+ * Point the existing button nodes to the buffers of the current theme.
+ * Returns false if the theme provides a different set of button states.
+ */
+static bool
+swap_button_buffers(struct wl_list *parts, enum ssd_part_type type,
+		struct lab_data_buffer *buffers[LAB_BS_ALL + 1])
+{
+	struct ssd_part *part = ssd_get_part(parts, type);
+	struct ssd_button *button = node_ssd_button_from_node(part->node);
+
+	for (uint8_t state_set = 0; state_set <= LAB_BS_ALL; state_set++) {
+		if (!button->nodes[state_set] != !buffers[state_set]) {
+			return false;
+		}
+	}
+	for (uint8_t state_set = 0; state_set <= LAB_BS_ALL; state_set++) {
+		if (buffers[state_set]) {
+			update_window_icon_buffer(button->nodes[state_set],
+				buffers[state_set]);
+		}
+	}
+	return true;
+}
+
+static bool
+title_buffer_is_stale(struct scaled_font_buffer *buffer, struct font *font,
+		const float *text_color, const float *bg_color)
+{
+	bool same_font_name = buffer->font.name && font->name
+		? !strcmp(buffer->font.name, font->name)
+		: buffer->font.name == font->name;
+
+	return !same_font_name
+		|| buffer->font.size != font->size
+		|| buffer->font.slant != font->slant
+		|| buffer->font.weight != font->weight
+		|| memcmp(buffer->color, text_color, sizeof(buffer->color))
+		|| memcmp(buffer->bg_color, bg_color, sizeof(buffer->bg_color));
+}
+
+bool
+ssd_titlebar_reconfigure(struct ssd *ssd)
+{
+	struct theme *theme = ssd->view->server->theme;
+	bool title_is_stale = false;
+
+	struct ssd_part *part;
+	struct ssd_sub_tree *subtree;
+	struct title_button *b;
+	FOR_EACH_STATE(ssd, subtree) {
+		bool active = subtree == &ssd->titlebar.active;
+		float *bg_color = active
+			? theme->window_active_title_bg_color
+			: theme->window_inactive_title_bg_color;
+
+		part = ssd_get_part(&subtree->parts, LAB_SSD_PART_TITLEBAR);
+		wlr_scene_rect_set_color(
+			wlr_scene_rect_from_node(part->node), bg_color);
+
+		part = ssd_get_part(&subtree->parts,
+			LAB_SSD_PART_TITLEBAR_CORNER_LEFT);
+		wlr_scene_buffer_set_buffer(wlr_scene_buffer_from_node(part->node),
+			active ? &theme->corner_top_left_active_normal->base
+			: &theme->corner_top_left_inactive_normal->base);
+
+		part = ssd_get_part(&subtree->parts,
+			LAB_SSD_PART_TITLEBAR_CORNER_RIGHT);
+		wlr_scene_buffer_set_buffer(wlr_scene_buffer_from_node(part->node),
+			active ? &theme->corner_top_right_active_normal->base
+			: &theme->corner_top_right_inactive_normal->base);
+
+		int state = active ? THEME_ACTIVE : THEME_INACTIVE;
+		wl_list_for_each(b, &rc.title_buttons_left, link) {
+			if (!swap_button_buffers(&subtree->parts, b->type,
+					theme->window[state].buttons[b->type])) {
+				return false;
+			}
+		}
+		wl_list_for_each(b, &rc.title_buttons_right, link) {
+			if (!swap_button_buffers(&subtree->parts, b->type,
+					theme->window[state].buttons[b->type])) {
+				return false;
+			}
+		}
+
+		part = ssd_get_part(&subtree->parts, LAB_SSD_PART_TITLE);
+		if (part && part->buffer) {
+			title_is_stale |= title_buffer_is_stale(part->buffer,
+				active ? &rc.font_activewindow
+				: &rc.font_inactivewindow,
+				active ? theme->window_active_label_text_color
+				: theme->window_inactive_label_text_color,
+				bg_color);
+		}
+	} FOR_EACH_END
+
+	/* The window icon button has just been reset to the theme buffers */
+	zfree(ssd->state.app_id);
+	ssd_update_window_icon(ssd);
+
+	/*
+	 * Forget the cached title to force a re-render if needed.
+	 * Otherwise this just updates the position in case the
+	 * justification changed.
+	 */
+	if (title_is_stale) {
+		zfree(ssd->state.title.text);
+	}
+	ssd_update_title(ssd);
+	return true;
+}
+
 void
 ssd_titlebar_destroy(struct ssd *ssd)
 {
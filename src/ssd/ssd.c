@@ -7,12 +7,14 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include <strings.h>
 #include "common/mem.h"
 #include "common/scene-helpers.h"
 #include "labwc.h"
 #include "ssd-internal.h"
 #include "theme.h"
+#include "trace.h"
 #include "view.h"
 
 struct border
@@ -167,6 +169,39 @@ ssd_resize_edges(enum ssd_part_type type)
 	}
 }
 
+static void
+get_layout(struct ssd_layout *layout, struct theme *theme)
+{
+	/* Zero padding as well since layouts are compared with memcmp() */
+	memset(layout, 0, sizeof(*layout));
+
+	layout->title_height = theme->title_height;
+	layout->border_width = theme->border_width;
+	layout->corner_width = ssd_get_corner_width();
+	layout->padding_width = theme->window_titlebar_padding_width;
+	layout->button_width = theme->window_button_width;
+	layout->button_height = theme->window_button_height;
+	layout->button_spacing = theme->window_button_spacing;
+	layout->show_title = rc.show_title;
+	layout->shadows_enabled = rc.shadows_enabled;
+	layout->active_shadow_size = theme->window_active_shadow_size;
+	layout->inactive_shadow_size = theme->window_inactive_shadow_size;
+
+	struct title_button *b;
+	wl_list_for_each(b, &rc.title_buttons_left, link) {
+		if (layout->nr_buttons_left < SSD_LAYOUT_MAX_BUTTONS) {
+			layout->buttons_left[layout->nr_buttons_left] = b->type;
+		}
+		layout->nr_buttons_left++;
+	}
+	wl_list_for_each(b, &rc.title_buttons_right, link) {
+		if (layout->nr_buttons_right < SSD_LAYOUT_MAX_BUTTONS) {
+			layout->buttons_right[layout->nr_buttons_right] = b->type;
+		}
+		layout->nr_buttons_right++;
+	}
+}
+
 struct ssd *
 ssd_create(struct view *view, bool active)
 {
@@ -174,6 +209,7 @@ ssd_create(struct view *view, bool active)
 	struct ssd *ssd = znew(*ssd);
 
 	ssd->view = view;
+	get_layout(&ssd->layout, view->server->theme);
 	ssd->tree = wlr_scene_tree_create(view->scene_tree);
 	wlr_scene_node_lower_to_bottom(&ssd->tree->node);
 	ssd->titlebar.height = view->server->theme->title_height;
@@ -224,6 +260,7 @@ ssd_update_margin(struct ssd *ssd)
 void
 ssd_update_geometry(struct ssd *ssd)
 {
+	TRACE_SPAN("ssd_update_geometry");
 	if (!ssd) {
 		return;
 	}
@@ -249,7 +286,13 @@ ssd_update_geometry(struct ssd *ssd)
 		|| ssd->state.was_squared != squared
 		|| ssd->state.was_omnipresent != view->visible_on_all_workspaces;
 
-	if (update_extents) {
+	/*
+	 * Extents are positioned relative to the view. When the view was
+	 * only moved, they just need to be re-clipped if they are or were
+	 * crossing a usable area boundary.
+	 */
+	if (update_extents && (update_area || state_changed
+			|| ssd_extents_may_clip(ssd))) {
 		ssd_extents_update(ssd);
 	}
 
@@ -304,6 +347,35 @@ ssd_destroy(struct ssd *ssd)
 	free(ssd);
 }
 
+bool
+ssd_reconfigure(struct ssd *ssd)
+{
+	if (!ssd) {
+		return false;
+	}
+
+	struct ssd_layout layout;
+	get_layout(&layout, ssd->view->server->theme);
+	if (layout.nr_buttons_left > SSD_LAYOUT_MAX_BUTTONS
+			|| layout.nr_buttons_right > SSD_LAYOUT_MAX_BUTTONS
+			|| memcmp(&layout, &ssd->layout, sizeof(layout))) {
+		return false;
+	}
+
+	/*
+	 * The titlebar goes first as it bails out if the new theme does not
+	 * provide the same set of button states, which are needed to keep
+	 * the existing button nodes.
+	 */
+	if (!ssd_titlebar_reconfigure(ssd)) {
+		return false;
+	}
+	ssd_border_reconfigure(ssd);
+	ssd_shadow_reconfigure(ssd);
+	ssd_enable_keybind_inhibit_indicator(ssd, ssd->view->inhibits_keybinds);
+	return true;
+}
+
 bool
 ssd_part_contains(enum ssd_part_type whole, enum ssd_part_type candidate)
 {
@@ -679,6 +679,20 @@ get_int_if_positive(const char *content, const char *field)
 	return value;
 }
 
+/*
+ * Keys can contain wildcards to set several properties at once, for example
+ * "window.*.title.bg.color", but the vast majority of them are plain property
+ * names. Only compile a pattern when the key actually is one.
+ */
+static bool
+match(const char *key, struct match_pattern *glob, const char *property)
+{
+	if (glob) {
+		return match_pattern(glob, property);
+	}
+	return !strcasecmp(key, property);
+}
+
 static void
 entry(struct theme *theme, const char *key, const char *value)
 {
@@ -686,82 +700,87 @@ entry(struct theme *theme, const char *key, const char *value)
 		return;
 	}
 
+	struct match_pattern *glob = NULL;
+	if (strpbrk(key, "*?[\\")) {
+		glob = match_pattern_create(key);
+	}
+
 	/*
 	 * Note that in order for the pattern match to apply to more than just
 	 * the first instance, "else if" cannot be used throughout this function
 	 */
-	if (match_glob(key, "border.width")) {
+	if (match(key, glob, "border.width")) {
 		theme->border_width = get_int_if_positive(
 			value, "border.width");
 	}
-	if (match_glob(key, "window.titlebar.padding.width")) {
+	if (match(key, glob, "window.titlebar.padding.width")) {
 		theme->window_titlebar_padding_width = get_int_if_positive(
 			value, "window.titlebar.padding.width");
 	}
-	if (match_glob(key, "window.titlebar.padding.height")) {
+	if (match(key, glob, "window.titlebar.padding.height")) {
 		theme->window_titlebar_padding_height = get_int_if_positive(
 			value, "window.titlebar.padding.height");
 	}
-	if (match_glob(key, "titlebar.height")) {
+	if (match(key, glob, "titlebar.height")) {
 		wlr_log(WLR_ERROR, "titlebar.height is no longer supported");
 	}
-	if (match_glob(key, "padding.height")) {
+	if (match(key, glob, "padding.height")) {
 		wlr_log(WLR_ERROR, "padding.height is no longer supported");
 	}
-	if (match_glob(key, "menu.items.padding.x")) {
+	if (match(key, glob, "menu.items.padding.x")) {
 		theme->menu_item_padding_x = get_int_if_positive(
 			value, "menu.items.padding.x");
 	}
-	if (match_glob(key, "menu.items.padding.y")) {
+	if (match(key, glob, "menu.items.padding.y")) {
 		theme->menu_item_padding_y = get_int_if_positive(
 			value, "menu.items.padding.y");
 	}
-	if (match_glob(key, "menu.title.text.justify")) {
+	if (match(key, glob, "menu.title.text.justify")) {
 		theme->menu_title_text_justify = parse_justification(value);
 	}
-	if (match_glob(key, "menu.overlap.x")) {
+	if (match(key, glob, "menu.overlap.x")) {
 		theme->menu_overlap_x = get_int_if_positive(
 			value, "menu.overlap.x");
 	}
-	if (match_glob(key, "menu.overlap.y")) {
+	if (match(key, glob, "menu.overlap.y")) {
 		theme->menu_overlap_y = get_int_if_positive(
 			value, "menu.overlap.y");
 	}
 
-	if (match_glob(key, "window.active.border.color")) {
+	if (match(key, glob, "window.active.border.color")) {
 		parse_hexstr(value, theme->window_active_border_color);
 	}
-	if (match_glob(key, "window.inactive.border.color")) {
+	if (match(key, glob, "window.inactive.border.color")) {
 		parse_hexstr(value, theme->window_inactive_border_color);
 	}
 	/* border.color is obsolete, but handled for backward compatibility */
-	if (match_glob(key, "border.color")) {
+	if (match(key, glob, "border.color")) {
 		parse_hexstr(value, theme->window_active_border_color);
 		parse_hexstr(value, theme->window_inactive_border_color);
 	}
 
-	if (match_glob(key, "window.active.indicator.toggled-keybind.color")) {
+	if (match(key, glob, "window.active.indicator.toggled-keybind.color")) {
 		parse_hexstr(value, theme->window_toggled_keybinds_color);
 	}
 
-	if (match_glob(key, "window.active.title.bg.color")) {
+	if (match(key, glob, "window.active.title.bg.color")) {
 		parse_hexstr(value, theme->window_active_title_bg_color);
 	}
-	if (match_glob(key, "window.inactive.title.bg.color")) {
+	if (match(key, glob, "window.inactive.title.bg.color")) {
 		parse_hexstr(value, theme->window_inactive_title_bg_color);
 	}
 
-	if (match_glob(key, "window.active.label.text.color")) {
+	if (match(key, glob, "window.active.label.text.color")) {
 		parse_hexstr(value, theme->window_active_label_text_color);
 	}
-	if (match_glob(key, "window.inactive.label.text.color")) {
+	if (match(key, glob, "window.inactive.label.text.color")) {
 		parse_hexstr(value, theme->window_inactive_label_text_color);
 	}
-	if (match_glob(key, "window.label.text.justify")) {
+	if (match(key, glob, "window.label.text.justify")) {
 		theme->window_label_text_justify = parse_justification(value);
 	}
 
-	if (match_glob(key, "window.button.width")) {
+	if (match(key, glob, "window.button.width")) {
 		theme->window_button_width = atoi(value);
 		if (theme->window_button_width < 1) {
 			wlr_log(WLR_ERROR, "window.button.width cannot "
@@ -769,7 +788,7 @@ entry(struct theme *theme, const char *key, const char *value)
 			theme->window_button_width = 1;
 		}
 	}
-	if (match_glob(key, "window.button.height")) {
+	if (match(key, glob, "window.button.height")) {
 		theme->window_button_height = atoi(value);
 		if (theme->window_button_height < 1) {
 			wlr_log(WLR_ERROR, "window.button.height cannot "
@@ -777,24 +796,24 @@ entry(struct theme *theme, const char *key, const char *value)
 			theme->window_button_height = 1;
 		}
 	}
-	if (match_glob(key, "window.button.spacing")) {
+	if (match(key, glob, "window.button.spacing")) {
 		theme->window_button_spacing = get_int_if_positive(
 			value, "window.button.spacing");
 	}
-	if (match_glob(key, "window.button.hover.bg.corner-radius")) {
+	if (match(key, glob, "window.button.hover.bg.corner-radius")) {
 		theme->window_button_hover_bg_corner_radius = get_int_if_positive(
 			value, "window.button.hover.bg.corner-radius");
 	}
 
 	/* universal button */
-	if (match_glob(key, "window.active.button.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.unpressed.image.color")) {
 		for (enum ssd_part_type type = LAB_SSD_BUTTON_FIRST;
 				type <= LAB_SSD_BUTTON_LAST; type++) {
 			parse_hexstr(value,
 				theme->window[THEME_ACTIVE].button_colors[type]);
 		}
 	}
-	if (match_glob(key, "window.inactive.button.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.unpressed.image.color")) {
 		for (enum ssd_part_type type = LAB_SSD_BUTTON_FIRST;
 				type <= LAB_SSD_BUTTON_LAST; type++) {
 			parse_hexstr(value,
@@ -803,132 +822,132 @@ entry(struct theme *theme, const char *key, const char *value)
 	}
 
 	/* individual buttons */
-	if (match_glob(key, "window.active.button.menu.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.menu.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_WINDOW_MENU]);
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_WINDOW_ICON]);
 	}
-	if (match_glob(key, "window.active.button.iconify.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.iconify.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_ICONIFY]);
 	}
-	if (match_glob(key, "window.active.button.max.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.max.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_MAXIMIZE]);
 	}
-	if (match_glob(key, "window.active.button.shade.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.shade.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_SHADE]);
 	}
-	if (match_glob(key, "window.active.button.desk.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.desk.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_OMNIPRESENT]);
 	}
-	if (match_glob(key, "window.active.button.close.unpressed.image.color")) {
+	if (match(key, glob, "window.active.button.close.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_ACTIVE]
 			.button_colors[LAB_SSD_BUTTON_CLOSE]);
 	}
-	if (match_glob(key, "window.inactive.button.menu.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.menu.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_WINDOW_MENU]);
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_WINDOW_ICON]);
 	}
-	if (match_glob(key, "window.inactive.button.iconify.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.iconify.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_ICONIFY]);
 	}
-	if (match_glob(key, "window.inactive.button.max.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.max.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_MAXIMIZE]);
 	}
-	if (match_glob(key, "window.inactive.button.shade.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.shade.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_SHADE]);
 	}
-	if (match_glob(key, "window.inactive.button.desk.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.desk.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_OMNIPRESENT]);
 	}
-	if (match_glob(key, "window.inactive.button.close.unpressed.image.color")) {
+	if (match(key, glob, "window.inactive.button.close.unpressed.image.color")) {
 		parse_hexstr(value, theme->window[THEME_INACTIVE]
 			.button_colors[LAB_SSD_BUTTON_CLOSE]);
 	}
 
 	/* window drop-shadows */
-	if (match_glob(key, "window.active.shadow.size")) {
+	if (match(key, glob, "window.active.shadow.size")) {
 		theme->window_active_shadow_size = get_int_if_positive(
 			value, "window.active.shadow.size");
 	}
-	if (match_glob(key, "window.inactive.shadow.size")) {
+	if (match(key, glob, "window.inactive.shadow.size")) {
 		theme->window_inactive_shadow_size = get_int_if_positive(
 			value, "window.inactive.shadow.size");
 	}
-	if (match_glob(key, "window.active.shadow.color")) {
+	if (match(key, glob, "window.active.shadow.color")) {
 		parse_hexstr(value, theme->window_active_shadow_color);
 	}
-	if (match_glob(key, "window.inactive.shadow.color")) {
+	if (match(key, glob, "window.inactive.shadow.color")) {
 		parse_hexstr(value, theme->window_inactive_shadow_color);
 	}
 
-	if (match_glob(key, "menu.width.min")) {
+	if (match(key, glob, "menu.width.min")) {
 		theme->menu_min_width = get_int_if_positive(
 			value, "menu.width.min");
 	}
-	if (match_glob(key, "menu.width.max")) {
+	if (match(key, glob, "menu.width.max")) {
 		theme->menu_max_width = get_int_if_positive(
 			value, "menu.width.max");
 	}
 
-	if (match_glob(key, "menu.items.bg.color")) {
+	if (match(key, glob, "menu.items.bg.color")) {
 		parse_hexstr(value, theme->menu_items_bg_color);
 	}
-	if (match_glob(key, "menu.items.text.color")) {
+	if (match(key, glob, "menu.items.text.color")) {
 		parse_hexstr(value, theme->menu_items_text_color);
 	}
-	if (match_glob(key, "menu.items.active.bg.color")) {
+	if (match(key, glob, "menu.items.active.bg.color")) {
 		parse_hexstr(value, theme->menu_items_active_bg_color);
 	}
-	if (match_glob(key, "menu.items.active.text.color")) {
+	if (match(key, glob, "menu.items.active.text.color")) {
 		parse_hexstr(value, theme->menu_items_active_text_color);
 	}
 
-	if (match_glob(key, "menu.separator.width")) {
+	if (match(key, glob, "menu.separator.width")) {
 		theme->menu_separator_line_thickness = get_int_if_positive(
 			value, "menu.separator.width");
 	}
-	if (match_glob(key, "menu.separator.padding.width")) {
+	if (match(key, glob, "menu.separator.padding.width")) {
 		theme->menu_separator_padding_width = get_int_if_positive(
 			value, "menu.separator.padding.width");
 	}
-	if (match_glob(key, "menu.separator.padding.height")) {
+	if (match(key, glob, "menu.separator.padding.height")) {
 		theme->menu_separator_padding_height = get_int_if_positive(
 			value, "menu.separator.padding.height");
 	}
-	if (match_glob(key, "menu.separator.color")) {
+	if (match(key, glob, "menu.separator.color")) {
 		parse_hexstr(value, theme->menu_separator_color);
 	}
 
-	if (match_glob(key, "menu.title.bg.color")) {
+	if (match(key, glob, "menu.title.bg.color")) {
 		parse_hexstr(value, theme->menu_title_bg_color);
 	}
 
-	if (match_glob(key, "menu.title.text.color")) {
+	if (match(key, glob, "menu.title.text.color")) {
 		parse_hexstr(value, theme->menu_title_text_color);
 	}
 
-	if (match_glob(key, "osd.bg.color")) {
+	if (match(key, glob, "osd.bg.color")) {
 		parse_hexstr(value, theme->osd_bg_color);
 	}
-	if (match_glob(key, "osd.border.width")) {
+	if (match(key, glob, "osd.border.width")) {
 		theme->osd_border_width = get_int_if_positive(
 			value, "osd.border.width");
 	}
-	if (match_glob(key, "osd.border.color")) {
+	if (match(key, glob, "osd.border.color")) {
 		parse_hexstr(value, theme->osd_border_color);
 	}
-	if (match_glob(key, "osd.window-switcher.width")) {
+	if (match(key, glob, "osd.window-switcher.width")) {
 		if (strrchr(value, '%')) {
 			theme->osd_window_switcher_width_is_percent = true;
 		} else {
@@ -937,86 +956,88 @@ entry(struct theme *theme, const char *key, const char *value)
 		theme->osd_window_switcher_width = get_int_if_positive(
 			value, "osd.window-switcher.width");
 	}
-	if (match_glob(key, "osd.window-switcher.padding")) {
+	if (match(key, glob, "osd.window-switcher.padding")) {
 		theme->osd_window_switcher_padding = get_int_if_positive(
 			value, "osd.window-switcher.padding");
 	}
-	if (match_glob(key, "osd.window-switcher.item.padding.x")) {
+	if (match(key, glob, "osd.window-switcher.item.padding.x")) {
 		theme->osd_window_switcher_item_padding_x =
 			get_int_if_positive(
 				value, "osd.window-switcher.item.padding.x");
 	}
-	if (match_glob(key, "osd.window-switcher.item.padding.y")) {
+	if (match(key, glob, "osd.window-switcher.item.padding.y")) {
 		theme->osd_window_switcher_item_padding_y =
 			get_int_if_positive(
 				value, "osd.window-switcher.item.padding.y");
 	}
-	if (match_glob(key, "osd.window-switcher.item.active.border.width")) {
+	if (match(key, glob, "osd.window-switcher.item.active.border.width")) {
 		theme->osd_window_switcher_item_active_border_width =
 			get_int_if_positive(
 				value, "osd.window-switcher.item.active.border.width");
 	}
-	if (match_glob(key, "osd.window-switcher.preview.border.width")) {
+	if (match(key, glob, "osd.window-switcher.preview.border.width")) {
 		theme->osd_window_switcher_preview_border_width =
 			get_int_if_positive(
 				value, "osd.window-switcher.preview.border.width");
 	}
-	if (match_glob(key, "osd.window-switcher.preview.border.color")) {
+	if (match(key, glob, "osd.window-switcher.preview.border.color")) {
 		parse_hexstrs(value, theme->osd_window_switcher_preview_border_color);
 	}
-	if (match_glob(key, "osd.workspace-switcher.boxes.width")) {
+	if (match(key, glob, "osd.workspace-switcher.boxes.width")) {
 		theme->osd_workspace_switcher_boxes_width =
 			get_int_if_positive(
 				value, "osd.workspace-switcher.boxes.width");
 	}
-	if (match_glob(key, "osd.workspace-switcher.boxes.height")) {
+	if (match(key, glob, "osd.workspace-switcher.boxes.height")) {
 		theme->osd_workspace_switcher_boxes_height =
 			get_int_if_positive(
 				value, "osd.workspace-switcher.boxes.height");
 	}
-	if (match_glob(key, "osd.label.text.color")) {
+	if (match(key, glob, "osd.label.text.color")) {
 		parse_hexstr(value, theme->osd_label_text_color);
 	}
-	if (match_glob(key, "snapping.overlay.region.bg.enabled")) {
+	if (match(key, glob, "snapping.overlay.region.bg.enabled")) {
 		set_bool(value, &theme->snapping_overlay_region.bg_enabled);
 	}
-	if (match_glob(key, "snapping.overlay.edge.bg.enabled")) {
+	if (match(key, glob, "snapping.overlay.edge.bg.enabled")) {
 		set_bool(value, &theme->snapping_overlay_edge.bg_enabled);
 	}
-	if (match_glob(key, "snapping.overlay.region.border.enabled")) {
+	if (match(key, glob, "snapping.overlay.region.border.enabled")) {
 		set_bool(value, &theme->snapping_overlay_region.border_enabled);
 	}
-	if (match_glob(key, "snapping.overlay.edge.border.enabled")) {
+	if (match(key, glob, "snapping.overlay.edge.border.enabled")) {
 		set_bool(value, &theme->snapping_overlay_edge.border_enabled);
 	}
-	if (match_glob(key, "snapping.overlay.region.bg.color")) {
+	if (match(key, glob, "snapping.overlay.region.bg.color")) {
 		parse_hexstr(value, theme->snapping_overlay_region.bg_color);
 	}
-	if (match_glob(key, "snapping.overlay.edge.bg.color")) {
+	if (match(key, glob, "snapping.overlay.edge.bg.color")) {
 		parse_hexstr(value, theme->snapping_overlay_edge.bg_color);
 	}
-	if (match_glob(key, "snapping.overlay.region.border.width")) {
+	if (match(key, glob, "snapping.overlay.region.border.width")) {
 		theme->snapping_overlay_region.border_width = get_int_if_positive(
 			value, "snapping.overlay.region.border.width");
 	}
-	if (match_glob(key, "snapping.overlay.edge.border.width")) {
+	if (match(key, glob, "snapping.overlay.edge.border.width")) {
 		theme->snapping_overlay_edge.border_width = get_int_if_positive(
 			value, "snapping.overlay.edge.border.width");
 	}
-	if (match_glob(key, "snapping.overlay.region.border.color")) {
+	if (match(key, glob, "snapping.overlay.region.border.color")) {
 		parse_hexstrs(value, theme->snapping_overlay_region.border_color);
 	}
-	if (match_glob(key, "snapping.overlay.edge.border.color")) {
+	if (match(key, glob, "snapping.overlay.edge.border.color")) {
 		parse_hexstrs(value, theme->snapping_overlay_edge.border_color);
 	}
 
-	if (match_glob(key, "magnifier.border.width")) {
+	if (match(key, glob, "magnifier.border.width")) {
 		theme->mag_border_width = get_int_if_positive(
 			value, "magnifier.border.width");
 	}
-	if (match_glob(key, "magnifier.border.color")) {
+	if (match(key, glob, "magnifier.border.color")) {
 		parse_hexstr(value, theme->mag_border_color);
 	}
+
+	match_pattern_destroy(glob);
 }
 
 static void
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <wlr/util/log.h>
+#include "common/macros.h"
+#include "trace.h"
+
+static const char * const marker_paths[] = {
+	"/sys/kernel/tracing/trace_marker",
+	"/sys/kernel/debug/tracing/trace_marker",
+};
+
+static int marker_fd = -1;
+static pid_t pid;
+
+static int
+get_marker_fd(void)
+{
+	static bool has_run;
+	if (has_run) {
+		return marker_fd;
+	}
+	has_run = true;
+	pid = getpid();
+
+	for (size_t i = 0; i < ARRAY_SIZE(marker_paths); i++) {
+		marker_fd = open(marker_paths[i], O_WRONLY | O_CLOEXEC);
+		if (marker_fd >= 0) {
+			wlr_log(WLR_INFO, "writing trace markers to %s",
+				marker_paths[i]);
+			return marker_fd;
+		}
+	}
+	wlr_log(WLR_ERROR, "cannot open trace_marker, tracing disabled");
+	return marker_fd;
+}
+
+static void
+write_marker(const char *marker, int len)
+{
+	if (len <= 0) {
+		return;
+	}
+	if (write(marker_fd, marker, len) < 0) {
+		/* Most likely permissions; don't retry on every frame */
+		wlr_log(WLR_ERROR, "cannot write trace marker, tracing disabled");
+		close(marker_fd);
+		marker_fd = -1;
+	}
+}
+
+const char *
+trace_span_begin(const char *name)
+{
+	if (get_marker_fd() < 0) {
+		return name;
+	}
+	char marker[128];
+	int len = snprintf(marker, sizeof(marker), "B|%d|%s", pid, name);
+	if (len >= (int)sizeof(marker)) {
+		len = sizeof(marker) - 1;
+	}
+	write_marker(marker, len);
+	return name;
+}
+
+void
+trace_span_end(const char **name)
+{
+	if (marker_fd < 0) {
+		return;
+	}
+	char marker[32];
+	write_marker(marker, snprintf(marker, sizeof(marker), "E|%d", pid));
+}
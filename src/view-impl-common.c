@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <strings.h>
 #include "common/list.h"
+#include "config/rcxml.h"
 #include "labwc.h"
 #include "view.h"
 #include "view-impl-common.h"
@@ -24,10 +25,55 @@ view_impl_move_to_back(struct view *view)
 	wlr_scene_node_lower_to_bottom(&view->scene_tree->node);
 }
 
+static void
+handle_map_batch_idle(void *data)
+{
+	struct server *server = data;
+	struct view *view = server->map_batch.focus;
+	server->map_batch.idle = NULL;
+	server->map_batch.focus = NULL;
+
+	/*
+	 * Window rules may have minimized the view or sent it to another
+	 * workspace in the meantime. Do not undo that by focusing it.
+	 * Otherwise focus switches to the view's workspace like it does
+	 * without deferring.
+	 */
+	if (!view || !view->mapped || view->minimized) {
+		return;
+	}
+	if (view->workspace != server->map_batch.workspace) {
+		return;
+	}
+	desktop_focus_view(view, /*raise*/ false);
+}
+
+/*
+ * When many clients map at once (session restore, autostart) focusing each
+ * of them in turn makes every client redraw as activated and deactivated
+ * again, so only the last view of such a burst gets focus.
+ */
+static void
+queue_map_focus(struct view *view)
+{
+	struct server *server = view->server;
+	server->map_batch.focus = view;
+	server->map_batch.workspace = view->workspace;
+	if (!server->map_batch.idle) {
+		server->map_batch.idle = wl_event_loop_add_idle(
+			server->wl_event_loop, handle_map_batch_idle, server);
+	}
+}
+
 void
 view_impl_map(struct view *view)
 {
-	desktop_focus_view(view, /*raise*/ true);
+	if (rc.defer_map_focus && !view->been_mapped) {
+		view_move_to_front(view);
+		queue_map_focus(view);
+	} else {
+		desktop_focus_view(view, /*raise*/ true);
+	}
 	view_update_title(view);
 	view_update_app_id(view);
 	if (!view->been_mapped) {
@@ -61,6 +107,9 @@ void
 view_impl_unmap(struct view *view)
 {
 	struct server *server = view->server;
+	if (view == server->map_batch.focus) {
+		server->map_batch.focus = NULL;
+	}
 	if (view == server->active_view) {
 		desktop_focus_topmost_view(server);
 	}
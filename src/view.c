@@ -21,6 +21,7 @@
 #include "snap-constraints.h"
 #include "snap.h"
 #include "ssd.h"
+#include "trace.h"
 #include "view.h"
 #include "window-rules.h"
 #include "wlr/util/log.h"
@@ -79,11 +80,11 @@ void
 view_query_free(struct view_query *query)
 {
 	wl_list_remove(&query->link);
-	zfree(query->identifier);
-	zfree(query->title);
-	zfree(query->sandbox_engine);
-	zfree(query->sandbox_app_id);
-	zfree(query->tiled_region);
+	match_pattern_destroy(query->identifier);
+	match_pattern_destroy(query->title);
+	match_pattern_destroy(query->sandbox_engine);
+	match_pattern_destroy(query->sandbox_app_id);
+	match_pattern_destroy(query->tiled_region);
 	zfree(query->desktop);
 	zfree(query->monitor);
 	zfree(query);
@@ -103,12 +104,12 @@ query_tristate_match(enum three_state desired, bool actual)
 }
 
 static bool
-query_str_match(const char *condition, const char *value)
+query_str_match(struct match_pattern *condition, const char *value)
 {
 	if (!condition) {
 		return true;
 	}
-	return value && match_glob(condition, value);
+	return value && match_pattern(condition, value);
 }
 
 bool
@@ -557,6 +558,7 @@ view_move(struct view *view, int x, int y)
 void
 view_moved(struct view *view)
 {
+	TRACE_SPAN("view_moved");
 	assert(view);
 	wlr_scene_node_set_position(&view->scene_tree->node,
 		view->current.x, view->current.y);
@@ -2311,6 +2313,15 @@ view_has_strut_partial(struct view *view)
 		view->impl->has_strut_partial(view);
 }
 
+void
+view_flush_configure(struct view *view)
+{
+	assert(view);
+	if (view->impl->flush_configure) {
+		view->impl->flush_configure(view);
+	}
+}
+
 const char *
 view_get_string_prop(struct view *view, const char *prop)
 {
@@ -2326,6 +2337,7 @@ void
 view_update_title(struct view *view)
 {
 	assert(view);
+	window_rules_invalidate(view);
 	const char *title = view_get_string_prop(view, "title");
 	if (!view->toplevel.handle || !title) {
 		return;
@@ -2338,6 +2350,7 @@ void
 view_update_app_id(struct view *view)
 {
 	assert(view);
+	window_rules_invalidate(view);
 	const char *app_id = view_get_string_prop(view, "app_id");
 	if (!view->toplevel.handle || !app_id) {
 		return;
@@ -2355,6 +2368,10 @@ view_reload_ssd(struct view *view)
 {
 	assert(view);
 	if (view->ssd_enabled && !view->fullscreen) {
+		/* Prefer updating the existing decorations over re-creating them */
+		if (ssd_reconfigure(view->ssd)) {
+			return;
+		}
 		undecorate(view);
 		decorate(view);
 	}
@@ -2472,6 +2489,7 @@ view_destroy(struct view *view)
 	struct server *server = view->server;
 
 	snap_constraints_invalidate(view);
+	window_rules_invalidate(view);
 
 	if (view->mappable.connected) {
 		mappable_disconnect(&view->mappable);
@@ -2500,6 +2518,10 @@ view_destroy(struct view *view)
 		server->active_view = NULL;
 	}
 
+	if (server->map_batch.focus == view) {
+		server->map_batch.focus = NULL;
+	}
+
 	if (server->session_lock_manager->last_active_view == view) {
 		server->session_lock_manager->last_active_view = NULL;
 	}
@@ -2,11 +2,13 @@
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 #include <cairo.h>
 #include <glib.h>
 #include <strings.h>
 #include <wlr/util/log.h>
 #include "action.h"
+#include "common/macros.h"
 #include "common/match.h"
 #include "config/rcxml.h"
 #include "labwc.h"
@@ -60,55 +62,119 @@ window_rules_apply(struct view *view, enum window_rule_event event)
 	}
 }
 
-enum property
-window_rules_get_property(struct view *view, const char *property)
+static const char * const prop_names[] = {
+	[LAB_WINDOW_RULE_PROP_SERVER_DECORATION] = "serverDecoration",
+	[LAB_WINDOW_RULE_PROP_SKIP_TASKBAR] = "skipTaskbar",
+	[LAB_WINDOW_RULE_PROP_SKIP_WINDOW_SWITCHER] = "skipWindowSwitcher",
+	[LAB_WINDOW_RULE_PROP_IGNORE_FOCUS_REQUEST] = "ignoreFocusRequest",
+	[LAB_WINDOW_RULE_PROP_IGNORE_CONFIGURE_REQUEST] = "ignoreConfigureRequest",
+	[LAB_WINDOW_RULE_PROP_FIXED_POSITION] = "fixedPosition",
+};
+
+static_assert(ARRAY_SIZE(prop_names) == LAB_WINDOW_RULE_PROP_COUNT,
+	"prop_names out of sync with enum window_rule_prop");
+
+/* Compared against view->window_rules_cache.generation, never zero */
+static uint32_t generation = 1;
+static bool have_match_once_rules;
+
+static void
+bump_generation(void)
 {
-	assert(property);
+	if (++generation == 0) {
+		generation = 1;
+	}
+}
+
+void
+window_rules_invalidate(struct view *view)
+{
+	assert(view);
+	if (have_match_once_rules) {
+		bump_generation();
+	} else {
+		view->window_rules_cache.generation = 0;
+	}
+}
+
+void
+window_rules_update(void)
+{
+	have_match_once_rules = false;
+	struct window_rule *rule;
+	wl_list_for_each(rule, &rc.window_rules, link) {
+		if (rule->match_once) {
+			have_match_once_rules = true;
+			break;
+		}
+	}
+	bump_generation();
+}
+
+static void
+set_prop(enum property *props, enum window_rule_prop prop, enum property value)
+{
+	/* The first value found wins, see update_cache() */
+	if (value && !props[prop]) {
+		props[prop] = value;
+	}
+}
+
+static void
+update_cache(struct view *view)
+{
+	struct window_rules_cache *cache = &view->window_rules_cache;
+	memset(cache->props, 0, sizeof(cache->props));
 
 	/*
 	 * We iterate in reverse here because later items in list have higher
-	 * priority. For example, in the config below we want the return value
-	 * for foot's "serverDecoration" property to be "default".
+	 * priority. For example, in the config below we want the value for
+	 * foot's "serverDecoration" property to be "default".
 	 *
 	 *     <windowRules>
 	 *       <windowRule identifier="*" serverDecoration="no"/>
 	 *       <windowRule identifier="foot" serverDecoration="default"/>
 	 *     </windowRules>
+	 *
+	 * A <windowRule> which does not set a particular property attribute
+	 * (LAB_PROP_UNSPECIFIED) leaves it to the rules with lower priority.
 	 */
 	struct window_rule *rule;
 	wl_list_for_each_reverse(rule, &rc.window_rules, link) {
-		/*
-		 * Only return if property != LAB_PROP_UNSPECIFIED otherwise a
-		 * <windowRule> which does not set a particular property
-		 * attribute would still return here if that property was asked
-		 * for.
-		 */
-		if (view_matches_criteria(rule, view)) {
-			if (rule->server_decoration
-					&& !strcasecmp(property, "serverDecoration")) {
-				return rule->server_decoration;
-			}
-			if (rule->skip_taskbar
-					&& !strcasecmp(property, "skipTaskbar")) {
-				return rule->skip_taskbar;
-			}
-			if (rule->skip_window_switcher
-					&& !strcasecmp(property, "skipWindowSwitcher")) {
-				return rule->skip_window_switcher;
-			}
-			if (rule->ignore_focus_request
-					&& !strcasecmp(property, "ignoreFocusRequest")) {
-				return rule->ignore_focus_request;
-			}
-			if (rule->ignore_configure_request
-					&& !strcasecmp(property, "ignoreConfigureRequest")) {
-				return rule->ignore_configure_request;
-			}
-			if (rule->fixed_position
-					&& !strcasecmp(property, "fixedPosition")) {
-				return rule->fixed_position;
-			}
+		if (!view_matches_criteria(rule, view)) {
+			continue;
+		}
+		enum property *props = cache->props;
+		set_prop(props, LAB_WINDOW_RULE_PROP_SERVER_DECORATION,
+			rule->server_decoration);
+		set_prop(props, LAB_WINDOW_RULE_PROP_SKIP_TASKBAR,
+			rule->skip_taskbar);
+		set_prop(props, LAB_WINDOW_RULE_PROP_SKIP_WINDOW_SWITCHER,
+			rule->skip_window_switcher);
+		set_prop(props, LAB_WINDOW_RULE_PROP_IGNORE_FOCUS_REQUEST,
+			rule->ignore_focus_request);
+		set_prop(props, LAB_WINDOW_RULE_PROP_IGNORE_CONFIGURE_REQUEST,
+			rule->ignore_configure_request);
+		set_prop(props, LAB_WINDOW_RULE_PROP_FIXED_POSITION,
+			rule->fixed_position);
+	}
+	cache->generation = generation;
+}
+
+enum property
+window_rules_get_property(struct view *view, const char *property)
+{
+	assert(property);
+
+	for (size_t i = 0; i < LAB_WINDOW_RULE_PROP_COUNT; i++) {
+		if (strcasecmp(property, prop_names[i])) {
+			continue;
+		}
+		if (view->window_rules_cache.generation != generation) {
+			update_cache(view);
 		}
+		return view->window_rules_cache.props[i];
 	}
+	wlr_log(WLR_ERROR, "unknown window rule property '%s'", property);
 	return LAB_PROP_UNSPECIFIED;
 }
@@ -59,16 +59,21 @@ xdg_toplevel_view_get_size_hints(struct view *view)
 }
 
 static bool
-xdg_toplevel_view_contains_window_type(struct view *view, int32_t window_type)
+xdg_toplevel_is_dialog(struct wlr_xdg_toplevel *toplevel)
 {
-	assert(view);
-
-	struct wlr_xdg_toplevel *toplevel = xdg_toplevel_from_view(view);
 	struct wlr_xdg_toplevel_state *state = &toplevel->current;
-	bool is_dialog = (state->min_width != 0 && state->min_height != 0
+	return (state->min_width != 0 && state->min_height != 0
 		&& (state->min_width == state->max_width
 		|| state->min_height == state->max_height))
 		|| toplevel->parent;
+}
+
+static bool
+xdg_toplevel_view_contains_window_type(struct view *view, int32_t window_type)
+{
+	assert(view);
+
+	bool is_dialog = xdg_toplevel_is_dialog(xdg_toplevel_from_view(view));
 
 	switch (window_type) {
 	case NET_WM_WINDOW_TYPE_NORMAL:
@@ -126,6 +131,18 @@ handle_commit(struct wl_listener *listener, void *data)
 	struct wlr_xdg_toplevel *toplevel = xdg_toplevel_from_view(view);
 	assert(view->surface);
 
+	/*
+	 * The window type matched by window rules is derived from the
+	 * size limits and the parent, so look out for changes here.
+	 */
+	struct xdg_toplevel_view *xdg_toplevel_view =
+		xdg_toplevel_view_from_view(view);
+	bool is_dialog = xdg_toplevel_is_dialog(toplevel);
+	if (is_dialog != xdg_toplevel_view->is_dialog) {
+		xdg_toplevel_view->is_dialog = is_dialog;
+		window_rules_invalidate(view);
+	}
+
 	if (xdg_surface->initial_commit) {
 		wlr_log(WLR_DEBUG, "scheduling configure");
 		wlr_xdg_surface_schedule_configure(xdg_surface);
@@ -199,12 +216,14 @@ handle_commit(struct wl_listener *listener, void *data)
 	}
 
 	uint32_t serial = view->pending_configure_serial;
+	bool configure_done = false;
 	if (serial > 0 && serial == xdg_surface->current.configure_serial) {
 		assert(view->pending_configure_timeout);
 		wl_event_source_remove(view->pending_configure_timeout);
 		view->pending_configure_serial = 0;
 		view->pending_configure_timeout = NULL;
 		update_required = true;
+		configure_done = true;
 	}
 
 	if (update_required) {
@@ -248,6 +267,10 @@ handle_commit(struct wl_listener *listener, void *data)
 			toplevel->scheduled.height = view->current.height;
 		}
 	}
+
+	if (configure_done) {
+		interactive_resize_configure_done(view);
+	}
 }
 
 static int
@@ -301,6 +324,8 @@ handle_configure_timeout(void *data)
 	snap_constraints_update(view);
 	view->pending = view->current;
 
+	interactive_resize_configure_done(view);
+
 	return 0; /* ignored per wl_event_loop docs */
 }
 
@@ -977,6 +1002,7 @@ xdg_toplevel_new(struct wl_listener *listener, void *data)
 	CONNECT_SIGNAL(xdg_surface, xdg_toplevel_view, new_popup);
 
 	wl_list_insert(&server->views, &view->link);
+	window_rules_invalidate(view);
 }
 
 void
@@ -335,9 +335,42 @@ handle_destroy(struct wl_listener *listener, void *data)
 	view_destroy(view);
 }
 
+static bool
+is_interactive_move(struct view *view, struct wlr_box geo)
+{
+	struct server *server = view->server;
+	return server->input_mode == LAB_INPUT_STATE_MOVE
+		&& server->grabbed_view == view
+		&& geo.width == view->current.width
+		&& geo.height == view->current.height
+		&& view->pending.width == view->current.width
+		&& view->pending.height == view->current.height;
+}
+
 static void
 xwayland_view_configure(struct view *view, struct wlr_box geo)
 {
+	struct xwayland_view *xwayland_view = xwayland_view_from_view(view);
+
+	/*
+	 * Each configure is an xcb ConfigureWindow plus a synthetic
+	 * ConfigureNotify. While the view is being dragged around, moves
+	 * may be applied several times per frame (resistance, untiling),
+	 * so just move the scene node here and let cursor_flush_move()
+	 * send a single configure per frame through
+	 * xwayland_view_flush_configure(). interactive_cancel() flushes
+	 * whatever is left at the end of the grab.
+	 */
+	if (is_interactive_move(view, geo)) {
+		xwayland_view->configure_deferred = true;
+		view->pending = geo;
+		view->current.x = geo.x;
+		view->current.y = geo.y;
+		view_moved(view);
+		return;
+	}
+
+	xwayland_view->configure_deferred = false;
 	view->pending = geo;
 	wlr_xwayland_surface_configure(xwayland_surface_from_view(view),
 		geo.x, geo.y, geo.width, geo.height);
@@ -362,6 +395,20 @@ xwayland_view_configure(struct view *view, struct wlr_box geo)
 	}
 }
 
+static void
+xwayland_view_flush_configure(struct view *view)
+{
+	struct xwayland_view *xwayland_view = xwayland_view_from_view(view);
+	if (!xwayland_view->configure_deferred
+			|| !xwayland_view->xwayland_surface) {
+		return;
+	}
+	xwayland_view->configure_deferred = false;
+	wlr_xwayland_surface_configure(xwayland_view->xwayland_surface,
+		view->pending.x, view->pending.y,
+		view->pending.width, view->pending.height);
+}
+
 static void
 handle_request_configure(struct wl_listener *listener, void *data)
 {
@@ -376,6 +423,17 @@ handle_request_configure(struct wl_listener *listener, void *data)
 		/* Honor client configure requests for floating views */
 		struct wlr_box box = {.x = event->x, .y = event->y,
 			.width = event->width, .height = event->height};
+		if (view->server->input_mode == LAB_INPUT_STATE_MOVE
+				&& view->server->grabbed_view == view) {
+			/*
+			 * The position is ours while the view is dragged
+			 * around. The client may not know about it yet,
+			 * since configures are deferred until the frame.
+			 * It is waiting for a reply though, so flush below.
+			 */
+			box.x = view->pending.x;
+			box.y = view->pending.y;
+		}
 		view_adjust_size(view, &box.width, &box.height);
 		xwayland_view_configure(view, box);
 	} else {
@@ -387,6 +445,7 @@ handle_request_configure(struct wl_listener *listener, void *data)
 		 */
 		xwayland_view_configure(view, view->pending);
 	}
+	xwayland_view_flush_configure(view);
 }
 
 static void
@@ -521,7 +580,9 @@ handle_set_decorations(struct wl_listener *listener, void *data)
 static void
 handle_set_window_type(struct wl_listener *listener, void *data)
 {
-	/* Intentionally left blank */
+	struct xwayland_view *xwayland_view =
+		wl_container_of(listener, xwayland_view, set_window_type);
+	window_rules_invalidate(&xwayland_view->base);
 }
 
 static void
@@ -720,6 +781,8 @@ xwayland_view_map(struct view *view)
 			wl_list_remove(&view->surface_destroy.link);
 		}
 		view->surface = xwayland_surface->surface;
+		/* Sandbox info is looked up through the surface */
+		window_rules_invalidate(view);
 
 		/* Required to set the surface to NULL when destroyed by the client */
 		view->surface_destroy.notify = handle_surface_destroy;
@@ -960,6 +1023,7 @@ static const struct view_impl xwayland_view_impl = {
 	.has_strut_partial = xwayland_view_has_strut_partial,
 	.contains_window_type = xwayland_view_contains_window_type,
 	.get_pid = xwayland_view_get_pid,
+	.flush_configure = xwayland_view_flush_configure,
 };
 
 void
@@ -1008,6 +1072,7 @@ xwayland_view_create(struct server *server,
 	CONNECT_SIGNAL(xsurface, xwayland_view, map_request);
 
 	wl_list_insert(&view->server->views, &view->link);
+	window_rules_invalidate(view);
 
 	if (xsurface->surface) {
 		handle_associate(&xwayland_view->associate, NULL);
@@ -1331,6 +1396,21 @@ xwayland_adjust_usable_area(struct view *view, struct wlr_output_layout *layout,
 	usable->height = usable_bottom - usable->y;
 }
 
+bool
+xwayland_output_affects_workarea(struct output *output)
+{
+	struct wlr_output_layout *layout = output->server->output_layout;
+	struct wlr_box lb, ob;
+	wlr_output_layout_get_box(layout, NULL, &lb);
+	wlr_output_layout_get_box(layout, output->wlr_output, &ob);
+
+	/* Same edges as in xwayland_update_workarea() */
+	return ob.x == MAX(0, lb.x)
+		|| ob.x + ob.width == MAX(0, lb.x + lb.width)
+		|| ob.y == MAX(0, lb.y)
+		|| ob.y + ob.height == MAX(0, lb.y + lb.height);
+}
+
 void
 xwayland_update_workarea(struct server *server)
 {
@@ -0,0 +1,922 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Synthetic Wayland client which maps a number of xdg-shell toplevels,
+ * drives scripted interactions through virtual keyboard/pointer devices
+ * and reports per-operation latency and compositor RSS.
+ *
+ * It expects to run inside labwc started by run-bench.sh which provides
+ * the keybinds, mousebinds and window rules used below.
+ */
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <linux/input-event-codes.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <wayland-client.h>
+#include <xkbcommon/xkbcommon.h>
+#include "virtual-keyboard-unstable-v1-client-protocol.h"
+#include "wlr-virtual-pointer-unstable-v1-client-protocol.h"
+#include "xdg-shell-client-protocol.h"
+
+#define PROBE_APP_ID "labwc-bench-probe"
+#define PROBE_SIZE 32
+#define SUBSURFACE_SIZE 48
+#define TIMEOUT_MS 2000
+
+/* Must match the rc.xml written by run-bench.sh */
+#define MOVETO_X 200
+#define MOVETO_Y 200
+
+struct sample_set {
+	const char *name;
+	int64_t *usec;
+	size_t len, alloc;
+	size_t timeouts;
+};
+
+enum op {
+	OP_MAP_CONFIGURE,
+	OP_MAP_FRAME,
+	OP_TITLE_DISPATCH,
+	OP_TITLE_FRAME,
+	OP_ALTTAB_ACTIVATE,
+	OP_ALTTAB_FRAME,
+	OP_MOVE_DISPATCH,
+	OP_MOVE_FRAME,
+	OP_RESIZE_CONFIGURE,
+	OP_RESIZE_FRAME,
+	OP_WORKSPACE_DISPATCH,
+	OP_WORKSPACE_FRAME,
+	OP_MENU_OPEN_DISPATCH,
+	OP_MENU_OPEN_FRAME,
+	OP_MENU_CLOSE_DISPATCH,
+	OP_MENU_CLOSE_FRAME,
+
+	OP_COUNT
+};
+
+static struct sample_set samples[OP_COUNT] = {
+	[OP_MAP_CONFIGURE] = { .name = "map.configure" },
+	[OP_MAP_FRAME] = { .name = "map.frame" },
+	[OP_TITLE_DISPATCH] = { .name = "title.dispatch" },
+	[OP_TITLE_FRAME] = { .name = "title.frame" },
+	[OP_ALTTAB_ACTIVATE] = { .name = "alttab.activate" },
+	[OP_ALTTAB_FRAME] = { .name = "alttab.frame" },
+	[OP_MOVE_DISPATCH] = { .name = "move.dispatch" },
+	[OP_MOVE_FRAME] = { .name = "move.frame" },
+	[OP_RESIZE_CONFIGURE] = { .name = "resize.configure" },
+	[OP_RESIZE_FRAME] = { .name = "resize.frame" },
+	[OP_WORKSPACE_DISPATCH] = { .name = "workspace.dispatch" },
+	[OP_WORKSPACE_FRAME] = { .name = "workspace.frame" },
+	[OP_MENU_OPEN_DISPATCH] = { .name = "menu.open.dispatch" },
+	[OP_MENU_OPEN_FRAME] = { .name = "menu.open.frame" },
+	[OP_MENU_CLOSE_DISPATCH] = { .name = "menu.close.dispatch" },
+	[OP_MENU_CLOSE_FRAME] = { .name = "menu.close.frame" },
+};
+
+struct shm_buffer {
+	struct wl_buffer *buffer;
+	bool busy;
+	bool stale;
+};
+
+struct window {
+	struct bench *bench;
+	struct wl_surface *surface;
+	struct xdg_surface *xdg_surface;
+	struct xdg_toplevel *toplevel;
+	struct shm_buffer *buffer;
+	int width, height;
+	int pending_width, pending_height;
+	bool activated;
+	bool configured;
+	uint32_t configure_serial;
+};
+
+struct bench {
+	struct wl_display *display;
+	struct wl_compositor *compositor;
+	struct wl_subcompositor *subcompositor;
+	struct wl_shm *shm;
+	struct wl_seat *seat;
+	struct wl_output *output;
+	struct xdg_wm_base *wm_base;
+	struct zwp_virtual_keyboard_manager_v1 *keyboard_manager;
+	struct zwlr_virtual_pointer_manager_v1 *pointer_manager;
+
+	struct zwp_virtual_keyboard_v1 *keyboard;
+	struct zwlr_virtual_pointer_v1 *pointer;
+	struct xkb_context *xkb_context;
+	struct xkb_keymap *xkb_keymap;
+	struct xkb_state *xkb_state;
+
+	int output_width, output_height;
+
+	struct window probe;
+	struct window *windows;
+	int nr_windows;
+	struct window *activated;
+	bool activation_changed;
+
+	uint32_t frames_requested;
+	uint32_t frames_done;
+};
+
+static struct {
+	int nr_windows;
+	int width, height;
+	int title_churn;
+	int subsurfaces;
+	int iterations;
+} opts = {
+	.nr_windows = 8,
+	.width = 640,
+	.height = 480,
+	.title_churn = 20,
+	.subsurfaces = 2,
+	.iterations = 20,
+};
+
+static int64_t
+now_usec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t
+now_msec(void)
+{
+	return (uint32_t)(now_usec() / 1000);
+}
+
+static void
+record(enum op op, int64_t start)
+{
+	struct sample_set *set = &samples[op];
+	if (set->len == set->alloc) {
+		set->alloc = set->alloc ? set->alloc * 2 : 64;
+		set->usec = realloc(set->usec, set->alloc * sizeof(*set->usec));
+		if (!set->usec) {
+			perror("realloc");
+			exit(EXIT_FAILURE);
+		}
+	}
+	set->usec[set->len++] = now_usec() - start;
+}
+
+/* Dispatch pending events or wait for new ones until the deadline */
+static bool
+dispatch_step(struct bench *bench, int64_t deadline)
+{
+	int ret = wl_display_dispatch_pending(bench->display);
+	if (ret != 0) {
+		return ret > 0;
+	}
+	wl_display_flush(bench->display);
+	int remaining = (deadline - now_usec()) / 1000;
+	if (remaining <= 0) {
+		return false;
+	}
+	struct pollfd pfd = {
+		.fd = wl_display_get_fd(bench->display),
+		.events = POLLIN,
+	};
+	if (poll(&pfd, 1, remaining) <= 0) {
+		return false;
+	}
+	return wl_display_dispatch(bench->display) >= 0;
+}
+
+/* Dispatch events until *flag becomes true or TIMEOUT_MS elapsed */
+static bool
+dispatch_until(struct bench *bench, bool *flag)
+{
+	int64_t deadline = now_usec() + TIMEOUT_MS * 1000;
+	while (!*flag) {
+		if (!dispatch_step(bench, deadline)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void
+handle_frame_done(void *data, struct wl_callback *callback, uint32_t time)
+{
+	struct bench *bench = data;
+	bench->frames_done++;
+	wl_callback_destroy(callback);
+}
+
+static const struct wl_callback_listener frame_listener = {
+	.done = handle_frame_done,
+};
+
+/*
+ * Request a frame callback on the given surface and wait for the
+ * compositor to present the next frame. The probe window is used for
+ * most operations as it is omnipresent and always-on-top, so it is
+ * guaranteed to be visible.
+ */
+static void
+wait_frame(struct bench *bench, struct wl_surface *surface, enum op op,
+		int64_t start)
+{
+	struct wl_callback *callback = wl_surface_frame(surface);
+	wl_callback_add_listener(callback, &frame_listener, bench);
+	wl_surface_commit(surface);
+	uint32_t target = ++bench->frames_requested;
+
+	int64_t deadline = now_usec() + TIMEOUT_MS * 1000;
+	while (bench->frames_done < target) {
+		if (!dispatch_step(bench, deadline)) {
+			break;
+		}
+	}
+	if (bench->frames_done < target) {
+		samples[op].timeouts++;
+		return;
+	}
+	record(op, start);
+}
+
+static void
+handle_buffer_release(void *data, struct wl_buffer *wl_buffer)
+{
+	struct shm_buffer *buffer = data;
+	buffer->busy = false;
+	if (buffer->stale) {
+		wl_buffer_destroy(buffer->buffer);
+		free(buffer);
+	}
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+	.release = handle_buffer_release,
+};
+
+static struct shm_buffer *
+create_buffer(struct bench *bench, int width, int height, uint32_t color)
+{
+	int stride = width * 4;
+	size_t size = (size_t)stride * height;
+	int fd = memfd_create("labwc-bench", MFD_CLOEXEC);
+	if (fd < 0 || ftruncate(fd, size) < 0) {
+		perror("memfd");
+		exit(EXIT_FAILURE);
+	}
+	uint32_t *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		fd, 0);
+	if (data == MAP_FAILED) {
+		perror("mmap");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t i = 0; i < size / 4; i++) {
+		data[i] = color;
+	}
+	munmap(data, size);
+
+	struct wl_shm_pool *pool = wl_shm_create_pool(bench->shm, fd, size);
+	struct shm_buffer *buffer = calloc(1, sizeof(*buffer));
+	if (!buffer) {
+		perror("calloc");
+		exit(EXIT_FAILURE);
+	}
+	buffer->buffer = wl_shm_pool_create_buffer(pool, 0, width, height,
+		stride, WL_SHM_FORMAT_XRGB8888);
+	wl_buffer_add_listener(buffer->buffer, &buffer_listener, buffer);
+	wl_shm_pool_destroy(pool);
+	close(fd);
+	return buffer;
+}
+
+static void
+attach_buffer(struct window *window, int width, int height, uint32_t color)
+{
+	struct shm_buffer *old = window->buffer;
+	window->buffer = create_buffer(window->bench, width, height, color);
+	window->buffer->busy = true;
+	wl_surface_attach(window->surface, window->buffer->buffer, 0, 0);
+	wl_surface_damage_buffer(window->surface, 0, 0, width, height);
+	window->width = width;
+	window->height = height;
+	if (!old) {
+		return;
+	}
+	if (old->busy) {
+		old->stale = true;
+	} else {
+		wl_buffer_destroy(old->buffer);
+		free(old);
+	}
+}
+
+static void
+handle_xdg_surface_configure(void *data, struct xdg_surface *xdg_surface,
+		uint32_t serial)
+{
+	struct window *window = data;
+	window->configure_serial = serial;
+	window->configured = true;
+}
+
+static const struct xdg_surface_listener xdg_surface_listener = {
+	.configure = handle_xdg_surface_configure,
+};
+
+static void
+handle_toplevel_configure(void *data, struct xdg_toplevel *toplevel,
+		int32_t width, int32_t height, struct wl_array *states)
+{
+	struct window *window = data;
+	struct bench *bench = window->bench;
+	window->pending_width = width;
+	window->pending_height = height;
+
+	bool activated = false;
+	uint32_t *state;
+	wl_array_for_each(state, states) {
+		if (*state == XDG_TOPLEVEL_STATE_ACTIVATED) {
+			activated = true;
+		}
+	}
+	window->activated = activated;
+	if (activated && bench->activated != window) {
+		bench->activated = window;
+		bench->activation_changed = true;
+	}
+}
+
+static void
+handle_toplevel_close(void *data, struct xdg_toplevel *toplevel)
+{
+	/* Not used */
+}
+
+static const struct xdg_toplevel_listener toplevel_listener = {
+	.configure = handle_toplevel_configure,
+	.close = handle_toplevel_close,
+};
+
+/* Ack the last configure and commit a buffer of the requested size */
+static void
+ack_and_attach(struct window *window, int default_width, int default_height,
+		uint32_t color)
+{
+	int width = window->pending_width ? window->pending_width : default_width;
+	int height = window->pending_height
+		? window->pending_height : default_height;
+	xdg_surface_ack_configure(window->xdg_surface, window->configure_serial);
+	window->configured = false;
+	attach_buffer(window, width, height, color);
+}
+
+static void
+add_subsurfaces(struct bench *bench, struct window *window, int count)
+{
+	for (int i = 0; i < count; i++) {
+		struct wl_surface *surface =
+			wl_compositor_create_surface(bench->compositor);
+		struct wl_subsurface *subsurface =
+			wl_subcompositor_get_subsurface(bench->subcompositor,
+				surface, window->surface);
+		wl_subsurface_set_position(subsurface,
+			8 + i * (SUBSURFACE_SIZE + 8), 8);
+		struct shm_buffer *buffer = create_buffer(bench,
+			SUBSURFACE_SIZE, SUBSURFACE_SIZE, 0xff3070c0);
+		buffer->busy = true;
+		wl_surface_attach(surface, buffer->buffer, 0, 0);
+		wl_surface_commit(surface);
+	}
+}
+
+static bool
+map_window(struct bench *bench, struct window *window, const char *app_id,
+		int width, int height, int subsurfaces, uint32_t color)
+{
+	window->bench = bench;
+	int64_t start = now_usec();
+	window->surface = wl_compositor_create_surface(bench->compositor);
+	window->xdg_surface = xdg_wm_base_get_xdg_surface(bench->wm_base,
+		window->surface);
+	xdg_surface_add_listener(window->xdg_surface, &xdg_surface_listener,
+		window);
+	window->toplevel = xdg_surface_get_toplevel(window->xdg_surface);
+	xdg_toplevel_add_listener(window->toplevel, &toplevel_listener, window);
+	xdg_toplevel_set_app_id(window->toplevel, app_id);
+	xdg_toplevel_set_title(window->toplevel, app_id);
+	wl_surface_commit(window->surface);
+
+	if (!dispatch_until(bench, &window->configured)) {
+		fprintf(stderr, "no initial configure for %s\n", app_id);
+		return false;
+	}
+	record(OP_MAP_CONFIGURE, start);
+
+	start = now_usec();
+	ack_and_attach(window, width, height, color);
+	add_subsurfaces(bench, window, subsurfaces);
+	wait_frame(bench, window->surface, OP_MAP_FRAME, start);
+	return true;
+}
+
+static void
+update_modifiers(struct bench *bench)
+{
+	struct xkb_state *state = bench->xkb_state;
+	zwp_virtual_keyboard_v1_modifiers(bench->keyboard,
+		xkb_state_serialize_mods(state, XKB_STATE_MODS_DEPRESSED),
+		xkb_state_serialize_mods(state, XKB_STATE_MODS_LATCHED),
+		xkb_state_serialize_mods(state, XKB_STATE_MODS_LOCKED),
+		xkb_state_serialize_layout(state, XKB_STATE_LAYOUT_EFFECTIVE));
+}
+
+static void
+send_key(struct bench *bench, uint32_t keycode, bool pressed)
+{
+	zwp_virtual_keyboard_v1_key(bench->keyboard, now_msec(), keycode,
+		pressed ? WL_KEYBOARD_KEY_STATE_PRESSED
+			: WL_KEYBOARD_KEY_STATE_RELEASED);
+	/* xkb keycodes are evdev keycodes offset by 8 */
+	xkb_state_update_key(bench->xkb_state, keycode + 8,
+		pressed ? XKB_KEY_DOWN : XKB_KEY_UP);
+	update_modifiers(bench);
+}
+
+/* Press all keys in order and release them in reverse order */
+static void
+send_combo(struct bench *bench, const uint32_t *keycodes, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		send_key(bench, keycodes[i], true);
+	}
+	for (size_t i = count; i > 0; i--) {
+		send_key(bench, keycodes[i - 1], false);
+	}
+}
+
+static void
+setup_keyboard(struct bench *bench)
+{
+	bench->xkb_context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+	struct xkb_rule_names names = { .layout = "us" };
+	bench->xkb_keymap = xkb_keymap_new_from_names(bench->xkb_context,
+		&names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+	if (!bench->xkb_keymap) {
+		fprintf(stderr, "cannot compile keymap\n");
+		exit(EXIT_FAILURE);
+	}
+	bench->xkb_state = xkb_state_new(bench->xkb_keymap);
+
+	char *keymap = xkb_keymap_get_as_string(bench->xkb_keymap,
+		XKB_KEYMAP_FORMAT_TEXT_V1);
+	size_t size = strlen(keymap) + 1;
+	int fd = memfd_create("labwc-bench-keymap", MFD_CLOEXEC);
+	if (fd < 0 || write(fd, keymap, size) != (ssize_t)size) {
+		perror("keymap");
+		exit(EXIT_FAILURE);
+	}
+	free(keymap);
+
+	bench->keyboard = zwp_virtual_keyboard_manager_v1_create_virtual_keyboard(
+		bench->keyboard_manager, bench->seat);
+	zwp_virtual_keyboard_v1_keymap(bench->keyboard,
+		WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1, fd, size);
+	close(fd);
+
+	bench->pointer = zwlr_virtual_pointer_manager_v1_create_virtual_pointer(
+		bench->pointer_manager, bench->seat);
+}
+
+static void
+pointer_move_to(struct bench *bench, int x, int y)
+{
+	if (x < 0) {
+		x = 0;
+	}
+	if (y < 0) {
+		y = 0;
+	}
+	zwlr_virtual_pointer_v1_motion_absolute(bench->pointer, now_msec(),
+		x, y, bench->output_width, bench->output_height);
+	zwlr_virtual_pointer_v1_frame(bench->pointer);
+}
+
+static void
+pointer_button(struct bench *bench, uint32_t button, bool pressed)
+{
+	zwlr_virtual_pointer_v1_button(bench->pointer, now_msec(), button,
+		pressed ? WL_POINTER_BUTTON_STATE_PRESSED
+			: WL_POINTER_BUTTON_STATE_RELEASED);
+	zwlr_virtual_pointer_v1_frame(bench->pointer);
+}
+
+static void
+bench_title_churn(struct bench *bench)
+{
+	char title[64];
+	for (int round = 0; round < opts.title_churn; round++) {
+		for (int i = 0; i < bench->nr_windows; i++) {
+			struct window *window = &bench->windows[i];
+			snprintf(title, sizeof(title), "labwc-bench %d.%d",
+				i, round);
+			int64_t start = now_usec();
+			xdg_toplevel_set_title(window->toplevel, title);
+			wl_display_roundtrip(bench->display);
+			record(OP_TITLE_DISPATCH, start);
+			wait_frame(bench, bench->probe.surface,
+				OP_TITLE_FRAME, start);
+		}
+	}
+}
+
+static void
+bench_alt_tab(struct bench *bench)
+{
+	static const uint32_t alt_tab[] = { KEY_LEFTALT, KEY_TAB };
+	for (int i = 0; i < opts.iterations; i++) {
+		bench->activation_changed = false;
+		int64_t start = now_usec();
+		send_combo(bench, alt_tab, 2);
+		if (dispatch_until(bench, &bench->activation_changed)) {
+			record(OP_ALTTAB_ACTIVATE, start);
+		} else {
+			samples[OP_ALTTAB_ACTIVATE].timeouts++;
+		}
+		wait_frame(bench, bench->probe.surface, OP_ALTTAB_FRAME, start);
+	}
+}
+
+/*
+ * Move the active window to a known position with a keybind, then drag
+ * it towards the left screen edge with Alt+Left so that resistance kicks
+ * in for the last steps.
+ */
+static void
+bench_move(struct bench *bench)
+{
+	static const uint32_t moveto[] = { KEY_LEFTMETA, KEY_F1 };
+	struct window *window = bench->activated;
+	if (!window) {
+		return;
+	}
+	send_combo(bench, moveto, 2);
+	wl_display_roundtrip(bench->display);
+
+	int x = MOVETO_X + window->width / 2;
+	int y = MOVETO_Y + window->height / 2;
+	int step = (x + 40) / (opts.iterations ? opts.iterations : 1) + 1;
+	pointer_move_to(bench, x, y);
+	send_key(bench, KEY_LEFTALT, true);
+	pointer_button(bench, BTN_LEFT, true);
+	for (int i = 0; i < opts.iterations; i++) {
+		x -= step;
+		int64_t start = now_usec();
+		pointer_move_to(bench, x, y);
+		wl_display_roundtrip(bench->display);
+		record(OP_MOVE_DISPATCH, start);
+		wait_frame(bench, bench->probe.surface, OP_MOVE_FRAME, start);
+	}
+	pointer_button(bench, BTN_LEFT, false);
+	send_key(bench, KEY_LEFTALT, false);
+	wl_display_roundtrip(bench->display);
+}
+
+/*
+ * Resize the active window with Alt+Right from its bottom-right quadrant
+ * and follow every configure like a well-behaved client would.
+ */
+static void
+bench_resize(struct bench *bench)
+{
+	static const uint32_t moveto[] = { KEY_LEFTMETA, KEY_F1 };
+	struct window *window = bench->activated;
+	if (!window) {
+		return;
+	}
+	send_combo(bench, moveto, 2);
+	wl_display_roundtrip(bench->display);
+
+	int x = MOVETO_X + window->width * 3 / 4;
+	int y = MOVETO_Y + window->height * 3 / 4;
+	pointer_move_to(bench, x, y);
+	send_key(bench, KEY_LEFTALT, true);
+	pointer_button(bench, BTN_RIGHT, true);
+	wl_display_roundtrip(bench->display);
+	for (int i = 0; i < opts.iterations; i++) {
+		x += 7;
+		y += 5;
+		window->configured = false;
+		int64_t start = now_usec();
+		pointer_move_to(bench, x, y);
+		if (!dispatch_until(bench, &window->configured)) {
+			samples[OP_RESIZE_CONFIGURE].timeouts++;
+			continue;
+		}
+		record(OP_RESIZE_CONFIGURE, start);
+		ack_and_attach(window, window->width, window->height,
+			0xff808080);
+		wait_frame(bench, window->surface, OP_RESIZE_FRAME, start);
+	}
+	pointer_button(bench, BTN_RIGHT, false);
+	send_key(bench, KEY_LEFTALT, false);
+	wl_display_roundtrip(bench->display);
+}
+
+static void
+bench_workspaces(struct bench *bench)
+{
+	static const uint32_t right[] = { KEY_LEFTCTRL, KEY_LEFTALT, KEY_RIGHT };
+	static const uint32_t left[] = { KEY_LEFTCTRL, KEY_LEFTALT, KEY_LEFT };
+	for (int i = 0; i < opts.iterations; i++) {
+		int64_t start = now_usec();
+		send_combo(bench, i % 2 ? left : right, 3);
+		wl_display_roundtrip(bench->display);
+		record(OP_WORKSPACE_DISPATCH, start);
+		wait_frame(bench, bench->probe.surface, OP_WORKSPACE_FRAME,
+			start);
+	}
+	if (opts.iterations % 2) {
+		send_combo(bench, left, 3);
+		wl_display_roundtrip(bench->display);
+	}
+}
+
+static void
+bench_menu(struct bench *bench)
+{
+	static const uint32_t menu_open[] = { KEY_LEFTMETA, KEY_M };
+	static const uint32_t menu_close[] = { KEY_ESC };
+	pointer_move_to(bench, bench->output_width / 3, bench->output_height / 3);
+	for (int i = 0; i < opts.iterations; i++) {
+		int64_t start = now_usec();
+		send_combo(bench, menu_open, 2);
+		wl_display_roundtrip(bench->display);
+		record(OP_MENU_OPEN_DISPATCH, start);
+		wait_frame(bench, bench->probe.surface, OP_MENU_OPEN_FRAME,
+			start);
+
+		start = now_usec();
+		send_combo(bench, menu_close, 1);
+		wl_display_roundtrip(bench->display);
+		record(OP_MENU_CLOSE_DISPATCH, start);
+		wait_frame(bench, bench->probe.surface, OP_MENU_CLOSE_FRAME,
+			start);
+	}
+}
+
+static void
+dump_frame_stats(struct bench *bench)
+{
+	static const uint32_t dump[] = { KEY_LEFTMETA, KEY_F12 };
+	send_combo(bench, dump, 2);
+	wl_display_roundtrip(bench->display);
+}
+
+static long
+compositor_rss_kb(void)
+{
+	const char *pid = getenv("LABWC_PID");
+	if (!pid) {
+		return -1;
+	}
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%s/status", pid);
+	FILE *stream = fopen(path, "r");
+	if (!stream) {
+		return -1;
+	}
+	char line[256];
+	long rss = -1;
+	while (fgets(line, sizeof(line), stream)) {
+		if (sscanf(line, "VmRSS: %ld kB", &rss) == 1) {
+			break;
+		}
+	}
+	fclose(stream);
+	return rss;
+}
+
+static int
+compare_usec(const void *a, const void *b)
+{
+	int64_t x = *(const int64_t *)a;
+	int64_t y = *(const int64_t *)b;
+	return (x > y) - (x < y);
+}
+
+static void
+report(long rss_start, long rss_mapped, long rss_end)
+{
+	printf("%-20s %8s %8s %8s %8s %8s\n", "operation (usec)",
+		"count", "p50", "p95", "max", "timeout");
+	for (size_t i = 0; i < OP_COUNT; i++) {
+		struct sample_set *set = &samples[i];
+		if (!set->len) {
+			printf("%-20s %8d %8s %8s %8s %8zu\n", set->name, 0,
+				"-", "-", "-", set->timeouts);
+			continue;
+		}
+		qsort(set->usec, set->len, sizeof(*set->usec), compare_usec);
+		printf("%-20s %8zu %8ld %8ld %8ld %8zu\n", set->name, set->len,
+			(long)set->usec[(set->len - 1) * 50 / 100],
+			(long)set->usec[(set->len - 1) * 95 / 100],
+			(long)set->usec[set->len - 1], set->timeouts);
+	}
+	printf("compositor rss (kB): start %ld, mapped %ld, end %ld\n",
+		rss_start, rss_mapped, rss_end);
+}
+
+static void
+handle_wm_base_ping(void *data, struct xdg_wm_base *wm_base, uint32_t serial)
+{
+	xdg_wm_base_pong(wm_base, serial);
+}
+
+static const struct xdg_wm_base_listener wm_base_listener = {
+	.ping = handle_wm_base_ping,
+};
+
+static void
+handle_output_mode(void *data, struct wl_output *output, uint32_t flags,
+		int32_t width, int32_t height, int32_t refresh)
+{
+	struct bench *bench = data;
+	if (flags & WL_OUTPUT_MODE_CURRENT) {
+		bench->output_width = width;
+		bench->output_height = height;
+	}
+}
+
+static void
+handle_output_geometry(void *data, struct wl_output *output, int32_t x,
+		int32_t y, int32_t physical_width, int32_t physical_height,
+		int32_t subpixel, const char *make, const char *model,
+		int32_t transform)
+{
+	/* Not used */
+}
+
+static const struct wl_output_listener output_listener = {
+	.geometry = handle_output_geometry,
+	.mode = handle_output_mode,
+};
+
+static void
+handle_global(void *data, struct wl_registry *registry, uint32_t name,
+		const char *interface, uint32_t version)
+{
+	struct bench *bench = data;
+	if (!strcmp(interface, wl_compositor_interface.name)) {
+		bench->compositor = wl_registry_bind(registry, name,
+			&wl_compositor_interface, 4);
+	} else if (!strcmp(interface, wl_subcompositor_interface.name)) {
+		bench->subcompositor = wl_registry_bind(registry, name,
+			&wl_subcompositor_interface, 1);
+	} else if (!strcmp(interface, wl_shm_interface.name)) {
+		bench->shm = wl_registry_bind(registry, name,
+			&wl_shm_interface, 1);
+	} else if (!strcmp(interface, wl_seat_interface.name) && !bench->seat) {
+		bench->seat = wl_registry_bind(registry, name,
+			&wl_seat_interface, 1);
+	} else if (!strcmp(interface, wl_output_interface.name)
+			&& !bench->output) {
+		bench->output = wl_registry_bind(registry, name,
+			&wl_output_interface, 1);
+		wl_output_add_listener(bench->output, &output_listener, bench);
+	} else if (!strcmp(interface, xdg_wm_base_interface.name)) {
+		bench->wm_base = wl_registry_bind(registry, name,
+			&xdg_wm_base_interface, 1);
+		xdg_wm_base_add_listener(bench->wm_base, &wm_base_listener,
+			bench);
+	} else if (!strcmp(interface,
+			zwp_virtual_keyboard_manager_v1_interface.name)) {
+		bench->keyboard_manager = wl_registry_bind(registry, name,
+			&zwp_virtual_keyboard_manager_v1_interface, 1);
+	} else if (!strcmp(interface,
+			zwlr_virtual_pointer_manager_v1_interface.name)) {
+		bench->pointer_manager = wl_registry_bind(registry, name,
+			&zwlr_virtual_pointer_manager_v1_interface, 1);
+	}
+}
+
+static void
+handle_global_remove(void *data, struct wl_registry *registry, uint32_t name)
+{
+	/* Not used */
+}
+
+static const struct wl_registry_listener registry_listener = {
+	.global = handle_global,
+	.global_remove = handle_global_remove,
+};
+
+static void
+usage(const char *name)
+{
+	printf("Usage: %s [options]\n"
+		"  -n <count>   number of windows (default %d)\n"
+		"  -W <width>   window width (default %d)\n"
+		"  -H <height>  window height (default %d)\n"
+		"  -t <rounds>  title changes per window (default %d)\n"
+		"  -s <count>   subsurfaces per window (default %d)\n"
+		"  -i <count>   iterations per interaction (default %d)\n",
+		name, opts.nr_windows, opts.width, opts.height,
+		opts.title_churn, opts.subsurfaces, opts.iterations);
+}
+
+int
+main(int argc, char *argv[])
+{
+	int c;
+	while ((c = getopt(argc, argv, "n:W:H:t:s:i:h")) != -1) {
+		switch (c) {
+		case 'n':
+			opts.nr_windows = atoi(optarg);
+			break;
+		case 'W':
+			opts.width = atoi(optarg);
+			break;
+		case 'H':
+			opts.height = atoi(optarg);
+			break;
+		case 't':
+			opts.title_churn = atoi(optarg);
+			break;
+		case 's':
+			opts.subsurfaces = atoi(optarg);
+			break;
+		case 'i':
+			opts.iterations = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return c == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+	if (opts.nr_windows < 1 || opts.width < 64 || opts.height < 64) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	struct bench bench = { 0 };
+	bench.display = wl_display_connect(NULL);
+	if (!bench.display) {
+		fprintf(stderr, "cannot connect to wayland display\n");
+		return EXIT_FAILURE;
+	}
+	struct wl_registry *registry = wl_display_get_registry(bench.display);
+	wl_registry_add_listener(registry, &registry_listener, &bench);
+	wl_display_roundtrip(bench.display);
+	wl_display_roundtrip(bench.display);
+	if (!bench.compositor || !bench.subcompositor || !bench.shm
+			|| !bench.seat || !bench.output || !bench.wm_base
+			|| !bench.keyboard_manager || !bench.pointer_manager) {
+		fprintf(stderr, "missing required globals\n");
+		return EXIT_FAILURE;
+	}
+
+	setup_keyboard(&bench);
+	long rss_start = compositor_rss_kb();
+
+	if (!map_window(&bench, &bench.probe, PROBE_APP_ID, PROBE_SIZE,
+			PROBE_SIZE, 0, 0xffff0000)) {
+		return EXIT_FAILURE;
+	}
+	bench.nr_windows = opts.nr_windows;
+	bench.windows = calloc(opts.nr_windows, sizeof(*bench.windows));
+	if (!bench.windows) {
+		perror("calloc");
+		return EXIT_FAILURE;
+	}
+	for (int i = 0; i < opts.nr_windows; i++) {
+		if (!map_window(&bench, &bench.windows[i], "labwc-bench",
+				opts.width, opts.height, opts.subsurfaces,
+				0xff202020 + i * 0x101010)) {
+			return EXIT_FAILURE;
+		}
+	}
+	long rss_mapped = compositor_rss_kb();
+
+	bench_title_churn(&bench);
+	bench_alt_tab(&bench);
+	bench_move(&bench);
+	bench_resize(&bench);
+	bench_workspaces(&bench);
+	bench_menu(&bench);
+	dump_frame_stats(&bench);
+
+	report(rss_start, rss_mapped, compositor_rss_kb());
+
+	wl_display_disconnect(bench.display);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#!/bin/sh
+#
+# Measure how long it takes labwc to parse a large rc.xml with hundreds of
+# keybinds, mousebinds and window rules. labwc is started on the headless
+# backend and reconfigured a number of times, the parse times are taken
+# from its debug log.
+#
+# Usage: parse-bench.sh <labwc> [reconfigure count]
+#
+
+labwc="$1"
+count="${2:-50}"
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+if [ -z "$XDG_RUNTIME_DIR" ]; then
+	export XDG_RUNTIME_DIR="$dir"
+fi
+
+keybinds() {
+	for mod in W- W-C- W-A- W-S- W-C-A- W-C-S- W-A-S- W-C-A-S-; do
+		for key in a b c d e f g h i j k l m n o p q r s t u v w x y z \
+				0 1 2 3 4 5 6 7 8 9 F1 F2 F3 F4 F5 F6 F7 F8 F9 F10; do
+			cat <<EOF
+    <keybind key="$mod$key">
+      <action name="If">
+        <query identifier="app-$key" />
+        <then><action name="Focus" /><action name="Raise" /></then>
+        <else><action name="Execute" command="true $mod$key" /></else>
+      </action>
+      <action name="MoveTo" x="10" y="10" />
+    </keybind>
+EOF
+		done
+	done
+}
+
+mousebinds() {
+	for context in Frame Client Title TitleBar Root; do
+		for mod in W- C- A- S- W-C- W-A- W-S- C-A- C-S- A-S-; do
+			for button in Left Middle Right; do
+				cat <<EOF
+      <mousebind button="$mod$button" action="Press">
+        <action name="Focus" /><action name="Raise" />
+      </mousebind>
+EOF
+			done
+		done
+	done
+}
+
+windowrules() {
+	i=0
+	while [ $i -lt 200 ]; do
+		cat <<EOF
+    <windowRule identifier="app-$i*" title="window $i" serverDecoration="no">
+      <action name="ToggleAlwaysOnTop" />
+    </windowRule>
+EOF
+		i=$((i + 1))
+	done
+}
+
+cat >"$dir/rc.xml" <<EOF
+<?xml version="1.0"?>
+<labwc_config>
+  <core>
+    <gap>4</gap>
+    <adaptiveSync>no</adaptiveSync>
+    <reuseOutputMode>no</reuseOutputMode>
+  </core>
+  <theme>
+    <name>labwc-bench</name>
+    <cornerRadius>8</cornerRadius>
+    <font place="ActiveWindow"><name>sans</name><size>10</size></font>
+    <font place="MenuItem"><name>sans</name><size>10</size></font>
+  </theme>
+  <focus>
+    <followMouse>no</followMouse>
+    <raiseOnFocus>no</raiseOnFocus>
+  </focus>
+  <desktops number="4">
+    <popupTime>0</popupTime>
+  </desktops>
+  <keyboard>
+    <repeatRate>25</repeatRate>
+    <repeatDelay>600</repeatDelay>
+$(keybinds)
+  </keyboard>
+  <mouse>
+    <context name="Frame">
+$(mousebinds)
+    </context>
+  </mouse>
+  <windowRules>
+$(windowrules)
+  </windowRules>
+</labwc_config>
+EOF
+
+WLR_BACKENDS=headless WLR_RENDERER=pixman WLR_LIBINPUT_NO_DEVICES=1 \
+	"$labwc" -d -C "$dir" \
+	-s "i=0; while [ \$i -lt $count ]; do kill -HUP \$LABWC_PID; \
+		sleep 0.2; i=\$((i + 1)); done; kill \$LABWC_PID" \
+	>"$dir/labwc.log" 2>&1
+
+sed -n 's/.*parsed config file in \([0-9]*\) us.*/\1/p' "$dir/labwc.log" \
+	| sort -n >"$dir/times"
+
+runs=$(wc -l <"$dir/times")
+if [ "$runs" -eq 0 ]; then
+	echo "no parse times found, labwc log:"
+	cat "$dir/labwc.log"
+	exit 1
+fi
+
+printf 'rc.xml: %s bytes, %s keybinds, %s runs\n' \
+	"$(wc -c <"$dir/rc.xml")" "$(grep -c '<keybind ' "$dir/rc.xml")" "$runs"
+awk '{ t[NR] = $1; sum += $1 }
+	END {
+		printf "parse: min %d us, median %d us, mean %d us, max %d us\n",
+			t[1], t[int((NR + 1) / 2)], sum / NR, t[NR]
+	}' "$dir/times"
@@ -0,0 +1,89 @@
+#!/bin/sh
+#
+# Run labwc-bench inside labwc on the headless backend with the pixman
+# renderer so that results do not depend on GPU or display hardware.
+#
+# Usage: run-bench.sh <labwc> <labwc-bench> [labwc-bench options]
+#
+
+labwc="$1"
+bench="$2"
+shift 2
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+if [ -z "$XDG_RUNTIME_DIR" ]; then
+	export XDG_RUNTIME_DIR="$dir"
+fi
+
+cat >"$dir/rc.xml" <<EOF
+<?xml version="1.0"?>
+<labwc_config>
+  <desktops number="2">
+    <popupTime>0</popupTime>
+  </desktops>
+  <resistance>
+    <screenEdgeStrength>20</screenEdgeStrength>
+    <windowEdgeStrength>20</windowEdgeStrength>
+  </resistance>
+  <keyboard>
+    <keybind key="A-Tab"><action name="NextWindow" /></keybind>
+    <keybind key="C-A-Right"><action name="GoToDesktop" to="right" wrap="no" /></keybind>
+    <keybind key="C-A-Left"><action name="GoToDesktop" to="left" wrap="no" /></keybind>
+    <keybind key="W-m"><action name="ShowMenu" menu="root-menu" /></keybind>
+    <keybind key="W-F1"><action name="MoveTo" x="200" y="200" /></keybind>
+    <keybind key="W-F12"><action name="DumpFrameStats" file="$dir/frame-stats" /></keybind>
+  </keyboard>
+  <mouse>
+    <context name="Frame">
+      <mousebind button="A-Left" action="Drag"><action name="Move" /></mousebind>
+      <mousebind button="A-Right" action="Drag"><action name="Resize" /></mousebind>
+    </context>
+  </mouse>
+  <windowRules>
+    <windowRule identifier="labwc-bench-probe" skipWindowSwitcher="yes">
+      <action name="ToggleOmnipresent" />
+      <action name="ToggleAlwaysOnTop" />
+    </windowRule>
+  </windowRules>
+</labwc_config>
+EOF
+
+cat >"$dir/menu.xml" <<EOF
+<?xml version="1.0"?>
+<openbox_menu>
+  <menu id="root-menu" label="">
+    <item label="One"><action name="None" /></item>
+    <item label="Two"><action name="None" /></item>
+    <menu id="sub" label="Sub">
+      <item label="Three"><action name="None" /></item>
+    </menu>
+    <separator />
+    <item label="Reconfigure"><action name="Reconfigure" /></item>
+  </menu>
+</openbox_menu>
+EOF
+
+cmd="'$bench'"
+for arg; do
+	cmd="$cmd '$arg'"
+done
+
+WLR_BACKENDS=headless WLR_RENDERER=pixman WLR_LIBINPUT_NO_DEVICES=1 \
+	"$labwc" -C "$dir" \
+	-s "$cmd >'$dir/result' 2>&1; echo \$? >'$dir/status'; kill \$LABWC_PID" \
+	>"$dir/labwc.log" 2>&1
+
+if [ ! -f "$dir/status" ]; then
+	echo "labwc-bench did not run, labwc log:"
+	cat "$dir/labwc.log"
+	exit 1
+fi
+
+cat "$dir/result"
+if [ -f "$dir/frame-stats" ]; then
+	echo
+	cat "$dir/frame-stats"
+fi
+exit "$(cat "$dir/status")"
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _GNU_SOURCE
+#include <fnmatch.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cmocka.h>
+#include "common/macros.h"
+#include "common/match.h"
+
+/* Typical window rule patterns, covering all the fast paths */
+static const char * const patterns[] = {
+	"foot",
+	"org.mozilla.firefox",
+	"*",
+	"org.gnome.*",
+	"*.desktop",
+	"*firefox*",
+	"*Mozilla Firefox",
+	"Steam*Friends*",
+	"jetbrains-?*",
+	"kitty-??",
+	"*[Pp]icture*",
+	"*\\*",
+	"",
+};
+
+static const char * const strings[] = {
+	"foot",
+	"FOOT",
+	"org.mozilla.firefox",
+	"org.gnome.Nautilus",
+	"org.gnome.Settings.desktop",
+	"firefox",
+	"New Tab — Mozilla Firefox",
+	"Picture-in-Picture",
+	"Steam - Friends List",
+	"jetbrains-idea",
+	"kitty-01",
+	"kitty-1",
+	"a*",
+	"Ärger — fööt",
+	"",
+};
+
+static void
+test_same_as_fnmatch(void **state)
+{
+	(void)state;
+
+	for (size_t i = 0; i < ARRAY_SIZE(patterns); i++) {
+		struct match_pattern *pattern = match_pattern_create(patterns[i]);
+		for (size_t j = 0; j < ARRAY_SIZE(strings); j++) {
+			bool expect = !fnmatch(patterns[i], strings[j], FNM_CASEFOLD);
+			if (match_pattern(pattern, strings[j]) != expect) {
+				fail_msg("'%s' vs '%s'", patterns[i], strings[j]);
+			}
+		}
+		match_pattern_destroy(pattern);
+	}
+}
+
+static void
+random_string(char *buf, size_t max, const char *alphabet)
+{
+	size_t len = rand() % max;
+	for (size_t i = 0; i < len; i++) {
+		buf[i] = alphabet[rand() % strlen(alphabet)];
+	}
+	buf[len] = '\0';
+}
+
+static void
+test_random_patterns(void **state)
+{
+	(void)state;
+
+	char pattern_str[16];
+	char string[24];
+	srand(1);
+	for (int i = 0; i < 100000; i++) {
+		random_string(pattern_str, sizeof(pattern_str), "aAbB.*?*");
+		random_string(string, sizeof(string), "aAbB.-");
+		struct match_pattern *pattern = match_pattern_create(pattern_str);
+		bool expect = !fnmatch(pattern_str, string, FNM_CASEFOLD);
+		if (match_pattern(pattern, string) != expect) {
+			fail_msg("'%s' vs '%s'", pattern_str, string);
+		}
+		match_pattern_destroy(pattern);
+	}
+}
+
+static double
+elapsed_msec(struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1e3
+		+ (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/* Not a pass/fail test, just prints the timings for comparison */
+static void
+bench_against_fnmatch(void **state)
+{
+	(void)state;
+
+	struct match_pattern *compiled[ARRAY_SIZE(patterns)];
+	for (size_t i = 0; i < ARRAY_SIZE(patterns); i++) {
+		compiled[i] = match_pattern_create(patterns[i]);
+	}
+
+	const int rounds = 2000;
+	size_t nr_fnmatch = 0, nr_compiled = 0;
+	struct timespec start;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int r = 0; r < rounds; r++) {
+		for (size_t i = 0; i < ARRAY_SIZE(patterns); i++) {
+			for (size_t j = 0; j < ARRAY_SIZE(strings); j++) {
+				nr_fnmatch += !fnmatch(patterns[i], strings[j],
+					FNM_CASEFOLD);
+			}
+		}
+	}
+	double fnmatch_msec = elapsed_msec(&start);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int r = 0; r < rounds; r++) {
+		for (size_t i = 0; i < ARRAY_SIZE(patterns); i++) {
+			for (size_t j = 0; j < ARRAY_SIZE(strings); j++) {
+				nr_compiled += match_pattern(compiled[i], strings[j]);
+			}
+		}
+	}
+	double compiled_msec = elapsed_msec(&start);
+
+	assert_int_equal(nr_fnmatch, nr_compiled);
+	size_t nr_calls = rounds * ARRAY_SIZE(patterns) * ARRAY_SIZE(strings);
+	printf("fnmatch:  %8.1f ns/match\n", fnmatch_msec * 1e6 / nr_calls);
+	printf("compiled: %8.1f ns/match\n", compiled_msec * 1e6 / nr_calls);
+
+	for (size_t i = 0; i < ARRAY_SIZE(patterns); i++) {
+		match_pattern_destroy(compiled[i]);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_same_as_fnmatch),
+		cmocka_unit_test(test_random_patterns),
+		cmocka_unit_test(bench_against_fnmatch),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}